@@ -1,4 +1,5 @@
 #include "attitudescene.h"
+#include "scalegeometry.h"
 #include <QGraphicsPathItem>
 #include <math.h>
 
@@ -245,10 +246,15 @@ void AttitudeScene::buildPitchLadder(QGraphicsScene& scene)
     // Set this to 0.5 for the pitch ladder to occupy the whole display
     double fractionToDraw = 0.5 - 3.0*majorTickMarkLength;
 
+    // Every major tick is labeled, so they are at least a line apart, and the
+    //   minor ticks are at least the minimum pitch apart
+    double major = spacingForPixels(majorSpacing, 2.0*fractionToDraw*pitchRange, pixelsPerDegree, fontMetrics.height());
+    double minor = spacingForPixels(minorSpacing, 2.0*fractionToDraw*pitchRange, pixelsPerDegree, minimumTickPitch);
+
     // Bottom of the range
     double angle = pitch - fractionToDraw*pitchRange;
 
-    angle -= fmod(angle, majorSpacing);
+    angle -= fmod(angle, major);
 
     // Major pitch ladder tick marks
     while(angle <= pitch + fractionToDraw*pitchRange)
@@ -263,20 +269,20 @@ void AttitudeScene::buildPitchLadder(QGraphicsScene& scene)
         ladder.addText(x+4, y + fontMetrics.xHeight(), font, text);
 
         // Next angle
-        angle += majorSpacing;
+        angle += major;
 
     }// while still drawing major marks
 
 
-    if((pitchMinorTickMarkLength > 0.0) && (minorSpacing > 0.0))
+    if((pitchMinorTickMarkLength > 0.0) && drawMinorTicks(minor, minorSpacing, major))
     {
         angle = pitch - fractionToDraw*pitchRange;
-        angle -= fmod(angle, minorSpacing);
+        angle -= fmod(angle, minor);
 
         // Minor pitch ladder tick marks
         while(angle <= pitch + fractionToDraw*pitchRange)
         {
-            if(fmod(angle, majorSpacing) != 0.0)
+            if(fmod(angle, major) != 0.0)
             {
                 double y = -angle*pixelsPerDegree;
                 double x = pitchMinorTickMarkLength*size.width()/2;
@@ -285,7 +291,7 @@ void AttitudeScene::buildPitchLadder(QGraphicsScene& scene)
             }
 
             // Next angle
-            angle += minorSpacing;
+            angle += minor;
 
         }// while still drawing minor marks
 
@@ -311,43 +317,44 @@ void AttitudeScene::buildRollScale(QGraphicsScene& scene)
 
     QPainterPath rollScale;
 
+    // No closer than the minimum pitch around the scale
+    double major = spacingForPixels(rollMajorSpacing, 240, deg2rad(innerRadius), minimumTickPitch);
+    double minor = spacingForPixels(rollMinorSpacing, 240, deg2rad(innerRadius), minimumTickPitch);
+
     // Starting angle, even divisions of major spacing
     double angle = -120;
-    double rem = fmod(angle, rollMajorSpacing);
+    double rem = fmod(angle, major);
     if(rem != 0.0)
-        angle += rollMajorSpacing - rem;
+        angle += major - rem;
 
-    // Major roll scale tick marks
-    while(angle <= 120)
-    {
-        rollScale.moveTo(-innerRadius*sin(deg2rad(angle)), innerRadius*cos(deg2rad(angle)));
-        rollScale.lineTo(-outerRadius*sin(deg2rad(angle)), outerRadius*cos(deg2rad(angle)));
+    // Major roll scale tick marks.  Zero roll points down the item, which is
+    //   -90 degrees for the geometry, and roll angles run the opposite way
+    ScaleGeometry geometry;
+    geometry.setAngles(-90.0 - angle, -major, ScaleGeometry::steps(angle, 120, major));
+    geometry.addTicks(rollScale, QPointF(), innerRadius, outerRadius);
 
-        // Setup for next loop
-        angle += rollMajorSpacing;
-    }
-
-    if((rollMinorSpacing > 0.0) && (minorTickMarkLength > 0.0))
+    if((minorTickMarkLength > 0.0) && drawMinorTicks(minor, rollMinorSpacing, major))
     {
         // Starting angle, even divisions of minor spacing
         angle = -120;
-        rem = fmod(angle, rollMinorSpacing);
+        rem = fmod(angle, minor);
         if(rem != 0.0)
-            angle += rollMinorSpacing - rem;
+            angle += minor - rem;
 
         // Minor roll scale tick marks
         outerRadius = (0.5+minorTickMarkLength)*pitchRange*pixelsPerDegree;
-        while(angle <= 120)
+        geometry.setAngles(-90.0 - angle, -minor, ScaleGeometry::steps(angle, 120, minor));
+        for(size_t i = 0; i < geometry.count(); i++)
         {
-            if(fmod(angle, rollMajorSpacing) != 0.0)
+            if(fmod(angle, major) != 0.0)
             {
-                rollScale.moveTo(-innerRadius*sin(deg2rad(angle)), innerRadius*cos(deg2rad(angle)));
-                rollScale.lineTo(-outerRadius*sin(deg2rad(angle)), outerRadius*cos(deg2rad(angle)));
+                rollScale.moveTo(geometry.point(i, QPointF(), innerRadius));
+                rollScale.lineTo(geometry.point(i, QPointF(), outerRadius));
             }// if location different than major ticks
 
-            angle += rollMinorSpacing;
+            angle += minor;
 
-        }// while drawing minor ticks
+        }// for all minor ticks
 
     }// if drawing minor ticks
 
@@ -470,7 +477,14 @@ void AttitudeScene::buildYawScale(QGraphicsScene& scene)
     // Start farthest left side of the display
     double startAngle = yaw - 0.5*size.width()/pixelsPerDegree;
     double endAngle = yaw + 0.5*size.width()/pixelsPerDegree;
-    double angle = startAngle - fmod(startAngle, majorSpacing);
+
+    // Every major tick is labeled, so they are at least the widest label
+    //   apart, and the minor ticks are at least the minimum pitch apart
+    double widest = fontMetrics.width(QString("%1").arg(360.0, 0, 'f', tickMarkPrecision)) + 4.0;
+    double major = spacingForPixels(majorSpacing, endAngle - startAngle, pixelsPerDegree, widest);
+    double minor = spacingForPixels(minorSpacing, endAngle - startAngle, pixelsPerDegree, minimumTickPitch);
+
+    double angle = startAngle - fmod(startAngle, major);
 
     // Draw the major ticks
     while(angle <= endAngle)
@@ -506,21 +520,21 @@ void AttitudeScene::buildYawScale(QGraphicsScene& scene)
         if((x+rect.width() < -4 - 0.5*labelRect.width()) || (x > 4 + 0.5*labelRect.width()))
             scale.addText(x, y, font, text);
 
-        angle += majorSpacing;
+        angle += major;
 
     }// while building major tick marks
 
 
-    if((minorSpacing > 0.0) || (minorTickMarkLength > 0.0))
+    if((minorTickMarkLength > 0.0) && drawMinorTicks(minor, minorSpacing, major))
     {
         // The top of the display
         y = -.50*size.height();
 
         // Now draw the minor ticks
-        angle = startAngle - fmod(startAngle, minorSpacing);
+        angle = startAngle - fmod(startAngle, minor);
         while(angle <= endAngle)
         {
-            if(fmod(angle, majorSpacing) != 0.0)
+            if(fmod(angle, major) != 0.0)
             {
                 double x = (angle-yaw)*pixelsPerDegree;
 
@@ -528,7 +542,7 @@ void AttitudeScene::buildYawScale(QGraphicsScene& scene)
                 scale.lineTo(x, y+minorTickMarkLength*size.height());
             }
 
-            angle += minorSpacing;
+            angle += minor;
 
         }// while building major tick marks
     }
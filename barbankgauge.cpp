@@ -0,0 +1,412 @@
+#include "barbankgauge.h"
+#include <QFontMetricsF>
+#include <QGraphicsTextItem>
+#include <QPainter>
+#include <QPainterPath>
+#include <QStyleOptionGraphicsItem>
+#include <QtNumeric>
+#include <math.h>
+
+/*!
+ * Create the item that draws a bank of bars.  Every bar starts empty, at the
+ * bottom of the area, in the low band.
+ * \param rect is the region of the scene covered by the bars
+ * \param bars is the number of bars
+ * \param gapFraction is the space between bars, as a fraction of the bar pitch
+ * \param parent is the parent item, which can be null
+ */
+BarBankItem::BarBankItem(const QRectF & rect, size_t bars, double gapFraction, QGraphicsItem* parent) :
+    QGraphicsItem(parent),
+    area(rect.normalized()),
+    pitch(0.0),
+    gap(0.0),
+    tops(bars, rect.normalized().bottom()),
+    bands(bars, 0)
+{
+    // The exposed rect is needed to skip bars that are not drawn
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+
+    if(bars > 0)
+        pitch = area.width()/bars;
+
+    gap = pitch*gapFraction;
+
+    colors[0] = Qt::white;
+    colors[1] = Qt::green;
+    colors[2] = Qt::red;
+}
+
+
+/*!
+ * Set the colors of the low, mid, and high bands, which repaints every bar
+ * \param low is the color of bars in the low band
+ * \param mid is the color of bars in the mid band
+ * \param high is the color of bars in the high band
+ */
+void BarBankItem::setBandColors(const QColor & low, const QColor & mid, const QColor & high)
+{
+    colors[0] = low;
+    colors[1] = mid;
+    colors[2] = high;
+    update();
+}
+
+
+/*!
+ * Set the top and band of a bar.  If either changed only the region covered by
+ * the bar, before and after, is invalidated.
+ * \param index is the index of the bar
+ * \param top is the top of the bar in the scene, which should already be
+ *        rounded to the pixel so that small changes are ignored
+ * \param band is 0 for the low band, 1 for mid, 2 for high
+ * \return true if the bar changed
+ */
+bool BarBankItem::setBar(size_t index, double top, uint8_t band)
+{
+    if((index >= tops.size()) || (band > 2))
+        return false;
+
+    if((tops[index] == top) && (bands[index] == band))
+        return false;
+
+    // The region from the higher of the two tops down to the bottom
+    double highest = (top < tops[index]) ? top : tops[index];
+
+    // A band change repaints the whole bar, else only the part that moved
+    double lowest = area.bottom();
+    if(bands[index] == band)
+        lowest = (top > tops[index]) ? top : tops[index];
+
+    tops[index] = top;
+    bands[index] = band;
+
+    update(QRectF(barLeft(index), highest, pitch - gap, lowest - highest).adjusted(-1, -1, 1, 1));
+    return true;
+
+}// BarBankItem::setBar
+
+
+/*!
+ * Draw the bars that are exposed, each is one filled rectangle
+ */
+void BarBankItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+    Q_UNUSED(widget);
+
+    if(tops.empty() || (pitch <= 0.0))
+        return;
+
+    // Only the bars in the exposed columns
+    QRectF exposed = option->exposedRect;
+    long first = (long)floor((exposed.left() - area.left())/pitch);
+    long last = (long)floor((exposed.right() - area.left())/pitch);
+    if(first < 0)
+        first = 0;
+    if(last >= (long)tops.size())
+        last = (long)tops.size() - 1;
+
+    for(long i = first; i <= last; i++)
+    {
+        if(tops[i] >= area.bottom())
+            continue;
+
+        painter->fillRect(QRectF(barLeft(i), tops[i], pitch - gap, area.bottom() - tops[i]), colors[bands[i]]);
+    }
+
+}// BarBankItem::paint
+
+
+BarBankGauge::BarBankGauge(void) :
+    size(),
+    channels(16),
+    barGap(0.2),
+    readings(channels, 0.0),
+    bankItem(0)
+{
+}
+
+
+/*!
+ * Set the size of the scene from the view rect.
+ * \param rect is the size of the view.
+ */
+void BarBankGauge::setSize(QRect rect)
+{
+    size = rect;
+    dirty = true;
+}
+
+
+/*!
+ * Set the number of channels.  New channels read the start of the scale.
+ * \param count is the number of channels, at least 1
+ */
+void BarBankGauge::setChannels(size_t count)
+{
+    if(count < 1)
+        count = 1;
+
+    channels = count;
+    readings.resize(channels, scaleStart);
+    dirty = true;
+}
+
+
+/*!
+ * Set the space between bars.
+ * \param gap is the space between bars, as a fraction of the bar pitch, from 0 to 0.9
+ */
+void BarBankGauge::setBarGap(double gap)
+{
+    if(gap < 0.0)
+        gap = 0.0;
+    else if(gap > 0.9)
+        gap = 0.9;
+
+    barGap = gap;
+    dirty = true;
+}
+
+
+/*!
+ * Set the readings of the channels.  If any other set call has been made
+ * before this one the scene will be considered dirty and completely rebuilt,
+ * otherwise only the bars whose pixel length or band changed are repainted.
+ * \param values is the reading of each channel, in order
+ * \param count is the number of readings, extra readings are ignored and
+ *        channels without a reading keep their last reading
+ */
+void BarBankGauge::setReadings(const double* values, size_t count)
+{
+    if(count > channels)
+        count = channels;
+
+    for(size_t i = 0; i < count; i++)
+        readings[i] = values[i];
+
+    if(dirty)
+        createScene(myScene);
+    else
+        updateBars(0, count);
+}
+
+
+/*!
+ * The bank has no single reading, so this only rebuilds the scene if it is dirty
+ * \param value is ignored
+ */
+void BarBankGauge::setReading(double value)
+{
+    setReading(value, value);
+}
+
+
+/*!
+ * The bank has no single reading, so this only rebuilds the scene if it is dirty
+ * \param pointerValue is ignored
+ * \param textValue is ignored
+ */
+void BarBankGauge::setReading(double pointerValue, double textValue)
+{
+    (void)pointerValue;
+    (void)textValue;
+
+    if(dirty)
+        createScene(myScene);
+}
+
+
+/*!
+ * Move a range of bars to their readings
+ * \param first is the index of the first channel to update
+ * \param count is the number of channels to update
+ */
+void BarBankGauge::updateBars(size_t first, size_t count)
+{
+    if(bankItem == 0)
+        return;
+
+    for(size_t i = first; (i < first + count) && (i < readings.size()); i++)
+    {
+        // A reading that is not a number shows as an empty bar
+        double reading = readings[i];
+        if(!qIsFinite(reading))
+            reading = scaleStart;
+
+        // Rounded to the pixel, so changes too small to see are not drawn
+        double top = floor(scaleToPixel(reading) + 0.5);
+        bankItem->setBar(i, top, bandFromReading(reading));
+    }
+}
+
+
+/*!
+ * Determine which band a reading is in
+ * \param reading is the reading
+ * \return 0 for the low band, 1 for mid, 2 for high
+ */
+uint8_t BarBankGauge::bandFromReading(double reading) const
+{
+    if(reading < getTopOfLowRange())
+        return 0;
+    else if(reading < getTopOfMidRange())
+        return 1;
+    else
+        return 2;
+}
+
+
+/*!
+ * Convert a reading from the users units to the vertical pixel location of the
+ * top of a bar
+ * \param scale is the value in users units
+ * \return the vertical pixel location
+ */
+double BarBankGauge::scaleToPixel(double scale) const
+{
+    double range = getTotalRange();
+    if(range <= 0.0)
+        return bankRect.bottom();
+
+    // Make sure in bounds
+    if(scale < scaleStart)
+        scale = scaleStart;
+    else if(scale > scaleStart + range)
+        scale = scaleStart + range;
+
+    // Vertical pixels are reversed
+    return bankRect.bottom() - bankRect.height()*(scale - scaleStart)/range;
+}
+
+
+/*!
+ * Build the tick marks, which run across the whole bank so every bar can be
+ * read against them.  Major ticks are solid, minor ticks are faint.
+ * \param scene is updated with the tickmarks
+ * \param bank is the region covered by the bars
+ */
+void BarBankGauge::buildTicks(QGraphicsScene& scene, const QRectF & bank)
+{
+    double endScale = getTopOfScale();
+
+    // No closer than the minimum pitch on the screen
+    double pixelsPerUnit = (getTotalRange() > 0.0) ? bank.height()/getTotalRange() : 0.0;
+    double major = spacingForPixels(majorSpacing, getTotalRange(), pixelsPerUnit, minimumTickPitch);
+    double minor = spacingForPixels(minorSpacing, getTotalRange(), pixelsPerUnit, minimumTickPitch);
+
+    if((minorTickMarkLength > 0.0) && drawMinorTicks(minor, minorSpacing, major))
+    {
+        QPainterPath path;
+        for(double scale = scaleStart; scale <= endScale; scale += minor)
+        {
+            path.moveTo(bank.left(), scaleToPixel(scale));
+            path.lineTo(bank.right(), scaleToPixel(scale));
+        }
+
+        QColor color = tickMarkColor;
+        color.setAlpha(color.alpha()/4);
+        QPen pen(color);
+        pen.setWidthF(1.0);
+        scene.addPath(path, pen)->setZValue(1.0);
+    }
+
+    if((majorTickMarkLength > 0.0) && (major > 0.0))
+    {
+        QPainterPath path;
+        for(double scale = scaleStart; scale <= endScale; scale += major)
+        {
+            path.moveTo(bank.left(), scaleToPixel(scale));
+            path.lineTo(bank.right(), scaleToPixel(scale));
+        }
+
+        QPen pen(tickMarkColor);
+        pen.setWidthF(1.0);
+        scene.addPath(path, pen)->setZValue(1.0);
+    }
+
+}// BarBankGauge::buildTicks
+
+
+/*!
+ * Build the tick mark labels, to the left of the bank.
+ * \param scene is updated with the labels
+ * \param bank is the region covered by the bars
+ */
+void BarBankGauge::buildLabels(QGraphicsScene& scene, const QRectF & bank)
+{
+    // Setting the tick mark length to 0 prevents drawing
+    if((majorTickMarkLength <= 0.0) || (majorSpacing <= 0.0) || (tickMarkLabelEnable == false))
+        return;
+
+    double endScale = getTopOfScale();
+
+    // Labels on major ticks, but at least a line apart
+    double pixelsPerUnit = (getTotalRange() > 0.0) ? bank.height()/getTotalRange() : 0.0;
+    double spacing = spacingForPixels(majorSpacing, getTotalRange(), pixelsPerUnit, minimumTickPitch);
+    spacing = spacingForPixels(spacing, getTotalRange(), pixelsPerUnit, QFontMetricsF(QFont()).height());
+
+    for(double scale = scaleStart; scale <= endScale; scale += spacing)
+    {
+        QString text = QString("%1").arg(scale, 0, 'f', tickMarkPrecision);
+        QGraphicsTextItem* item = scene.addText(text, QFont());
+        item->setDefaultTextColor(tickMarkColor);
+
+        // Right justified against the bank
+        QPointF location(bank.left(), scaleToPixel(scale));
+        location += rectOffsetForRightCenter(item->boundingRect());
+        item->setPos(location);
+    }
+
+}// BarBankGauge::buildLabels
+
+
+/*!
+ * Create the scene, redrawing all elements
+ * \param scene will be cleared and then completely rebuilt
+ */
+void BarBankGauge::createScene(QGraphicsScene& scene)
+{
+    // Set the background
+    scene.setBackgroundBrush(backgroundColor);
+
+    // remove all items currently in the scene
+    scene.clear();
+
+    // Set the size of the scene
+    scene.setSceneRect(0, 0, size.width(), size.height());
+
+    // Does not exist now
+    bankItem = 0;
+
+    // Room on the left for the widest label, and half a line above and below
+    //   so the top and bottom labels fit
+    QRectF bank(0, 0, size.width(), size.height());
+    if((majorTickMarkLength > 0.0) && (majorSpacing > 0.0) && tickMarkLabelEnable)
+    {
+        QFontMetricsF metrics((QFont()));
+        double widest = metrics.width(QString("%1").arg(scaleStart, 0, 'f', tickMarkPrecision));
+        double top = metrics.width(QString("%1").arg(getTopOfScale(), 0, 'f', tickMarkPrecision));
+        if(top > widest)
+            widest = top;
+
+        bank.adjust(widest + 8.0, 0.5*metrics.height(), 0, -0.5*metrics.height());
+    }
+
+    bankRect = bank;
+
+    // All the bars
+    bankItem = new BarBankItem(bankRect, channels, barGap);
+    bankItem->setBandColors(lowColor, midColor, highColor);
+    scene.addItem(bankItem);
+
+    // The tick marks are drawn over the bars
+    buildTicks(scene, bankRect);
+    buildLabels(scene, bankRect);
+
+    // No longer dirty
+    dirty = false;
+
+    // The variable stuff
+    updateBars(0, channels);
+
+}// BarBankGauge::createScene
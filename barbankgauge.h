@@ -0,0 +1,114 @@
+#ifndef BARBANKGAUGE_H
+#define BARBANKGAUGE_H
+
+#include "gauge.h"
+#include <QGraphicsItem>
+#include <QColor>
+#include <QRectF>
+#include <vector>
+#include <stdint.h>
+
+/*!
+ * \brief The BarBankItem class draws every bar of a BarBankGauge as one
+ * graphics item.
+ *
+ * Each bar is a filled rectangle from the bottom of the item up to its top,
+ * in one of the three band colors. Changing a bar only invalidates the part
+ * of the item that the bar covers, and only if its top or band changed.
+ */
+class BarBankItem : public QGraphicsItem
+{
+public:
+    //! Create the item for a number of bars filling a region of the scene
+    BarBankItem(const QRectF & area, size_t bars, double gap, QGraphicsItem* parent = 0);
+
+    //! Set the colors of the low, mid, and high bands
+    void setBandColors(const QColor & low, const QColor & mid, const QColor & high);
+
+    //! Set the top and band of a bar, and invalidate it if either changed
+    bool setBar(size_t index, double top, uint8_t band);
+
+    //! \return the number of bars
+    size_t count(void) const {return tops.size();}
+
+    //! \return the region of the scene covered by the bars
+    virtual QRectF boundingRect(void) const override {return area;}
+
+    //! Draw the bars that are exposed
+    virtual void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = 0) override;
+
+protected:
+    //! \return the left edge of a bar
+    double barLeft(size_t index) const {return area.left() + index*pitch + 0.5*gap;}
+
+    QRectF area;                //!< Region of the scene covered by the bars
+    double pitch;               //!< Distance from the left of one bar to the left of the next
+    double gap;                 //!< Space between bars
+    QColor colors[3];           //!< Color of the low, mid, and high bands
+    std::vector<double> tops;   //!< Top of each bar in the scene, the bottom is the bottom of the area
+    std::vector<uint8_t> bands; //!< Band of each bar, 0 for low, 1 for mid, 2 for high
+};
+
+
+/*!
+ * \brief The BarBankGauge class uses QGraphicsScene to display many similar
+ * channels as a bank of vertical bars on one scale.
+ *
+ * The scale, the low, mid, and high bands and their colors, and the tick marks
+ * are configured with the Gauge functions, and are shared by every bar. All the
+ * bars are drawn by one BarBankItem, in one scene and one view. Readings are
+ * given in bulk with setReadings(), and only the bars whose pixel length or
+ * band changed are repainted. There is no reading text, since there are too
+ * many channels for it to be useful.
+ */
+class BarBankGauge : public Gauge
+{
+public:
+    BarBankGauge();
+
+    //! \return the number of channels
+    size_t getChannels(void) const {return channels;}
+
+    //! \return the space between bars, as a fraction of the bar pitch
+    double getBarGap(void) const {return barGap;}
+
+    //! Set the size the scene from the view rect
+    void setSize(QRect rect) override;
+
+    //! Set the number of channels
+    void setChannels(size_t count);
+
+    //! Set the space between bars, as a fraction of the bar pitch
+    void setBarGap(double gap);
+
+    //! Set the readings of the channels from a contiguous array
+    void setReadings(const double* values, size_t count);
+
+    //! Set the readings of the channels
+    void setReadings(const std::vector<double> & values) {setReadings(values.data(), values.size());}
+
+    //! Redraw the scene if it is dirty, the bank has no single reading
+    void setReading(double value) override;
+
+    //! Redraw the scene if it is dirty, the bank has no single reading
+    void setReading(double pointerValue, double textValue) override;
+
+protected: // methods
+    virtual void createScene(QGraphicsScene& scene) override;
+
+    void buildTicks(QGraphicsScene& scene, const QRectF & bank);
+    void buildLabels(QGraphicsScene& scene, const QRectF & bank);
+    void updateBars(size_t first, size_t count);
+    uint8_t bandFromReading(double reading) const;
+    double scaleToPixel(double scale) const;
+
+protected:    // properties
+    QRect size;                     //!< The size of the viewing rect
+    size_t channels;                //!< Number of channels
+    double barGap;                  //!< Space between bars, as a fraction of the bar pitch
+    std::vector<double> readings;   //!< Reading of each channel
+    QRectF bankRect;                //!< Region of the scene covered by the bars
+    BarBankItem* bankItem;          //!< Draws all the bars
+};
+
+#endif // BARBANKGAUGE_H
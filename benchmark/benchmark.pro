@@ -0,0 +1,37 @@
+#-------------------------------------------------
+#
+# Scaling benchmark of TwoDimensionalPlot, built on its own so the gauges
+# application does not depend on it. Run it from a terminal, it uses the
+# offscreen platform unless QT_QPA_PLATFORM is already set.
+#
+#-------------------------------------------------
+
+QT       += core gui widgets concurrent
+
+TARGET = benchmark
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+QMAKE_CXXFLAGS += -Wno-unused-parameter
+
+INCLUDEPATH += ..
+
+SOURCES += main.cpp \
+    ../colormap.cpp \
+    ../curveitem.cpp \
+    ../minmaxpyramid.cpp \
+    ../plothover.cpp \
+    ../scatteritem.cpp \
+    ../tiffstripwriter.cpp \
+    ../twodimensionalplot.cpp \
+    ../twodimensionalscene.cpp
+
+HEADERS  += ../colormap.h \
+    ../curveitem.h \
+    ../minmaxpyramid.h \
+    ../plothover.h \
+    ../scatteritem.h \
+    ../tiffstripwriter.h \
+    ../twodimensionalplot.h \
+    ../twodimensionalscene.h
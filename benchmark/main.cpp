@@ -0,0 +1,235 @@
+#include "twodimensionalplot.h"
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QGraphicsView>
+#include <QPixmap>
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <sys/resource.h>
+#include <vector>
+
+//! \return the high water mark of the resident memory of the process in megabytes
+static double peakMegabytes(void)
+{
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0.0;
+
+    // Linux reports kilobytes, macOS reports bytes
+    #ifdef Q_OS_MAC
+    return usage.ru_maxrss/(1024.0*1024.0);
+    #else
+    return usage.ru_maxrss/1024.0;
+    #endif
+}
+
+
+//! \return the milliseconds elapsed since a timer was started
+static double milliseconds(const QElapsedTimer & timer)
+{
+    return timer.nsecsElapsed()*1.0e-6;
+}
+
+
+/*!
+ * Fill the x data of a benchmark case
+ * \param x receives the data
+ * \param samples is the number of samples
+ * \param monotonic is true for evenly increasing data, false for a random walk
+ *        that goes back and forth
+ * \param random generates the walk
+ */
+static void makeX(plotData & x, size_t samples, bool monotonic, std::mt19937 & random)
+{
+    x.data.resize(samples);
+    x.title = "Time";
+
+    if(monotonic)
+    {
+        for(size_t i = 0; i < samples; i++)
+            x.data[i] = i*0.001;
+    }
+    else
+    {
+        std::normal_distribution<double> step(0.0, 1.0);
+        double value = 0.0;
+        for(size_t i = 0; i < samples; i++)
+        {
+            value += step(random);
+            x.data[i] = value;
+        }
+    }
+
+}// makeX
+
+
+/*!
+ * Fill the y data of one channel of a benchmark case, a sine wave of its own
+ * frequency with noise on top.
+ * \param y receives the data
+ * \param samples is the number of samples
+ * \param channel is the index of the channel
+ * \param random generates the noise
+ */
+static void makeY(plotData & y, size_t samples, int channel, std::mt19937 & random)
+{
+    std::normal_distribution<double> noise(0.0, 0.1);
+    double frequency = 0.0001*(channel + 1);
+
+    y.data.resize(samples);
+    for(size_t i = 0; i < samples; i++)
+        y.data[i] = sin(frequency*i) + channel + noise(random);
+
+    y.title = QString("Channel %1").arg(channel);
+    y.color = QColor::fromHsv((channel*37) % 360, 255, 200);
+
+}// makeY
+
+
+/*!
+ * Run one benchmark case and print one row of results.  Each stage is timed
+ * on its own: the range and tick marks of the data, the generation of the
+ * plot, fitting the plot to the view, and the first paint of the view.  The
+ * peak memory is of the whole process, so the growth of the peak during the
+ * case is printed with it; a growth of 0 means the case stayed under the peak
+ * of an earlier case.
+ * \param channels is the number of y channels
+ * \param samples is the number of samples in each channel
+ * \param monotonic is true for increasing x data
+ * \param width is the width of the view in pixels
+ * \param height is the height of the view in pixels
+ */
+static void runCase(int channels, size_t samples, bool monotonic, int width, int height)
+{
+    std::mt19937 random(1234);
+
+    double peakBefore = peakMegabytes();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    plotData x;
+    makeX(x, samples, monotonic, random);
+
+    std::vector<plotData> y(channels);
+    plotSet ySet;
+    for(int c = 0; c < channels; c++)
+    {
+        makeY(y[c], samples, c, random);
+        ySet.push_back(&y[c]);
+    }
+
+    double generate = milliseconds(timer);
+
+    // Range and tick marks, as done once per axis by each plot
+    double minValue, maxValue, start, end;
+    timer.restart();
+    TwoDimensionalPlot::getRange(&x, &minValue, &maxValue);
+    TwoDimensionalPlot::getRange(ySet, &minValue, &maxValue);
+    double range = milliseconds(timer);
+
+    timer.restart();
+    TwoDimensionalPlot::tickMarks(&x, 10, &start, &end);
+    TwoDimensionalPlot::tickMarks(ySet, 10, &start, &end);
+    double ticks = milliseconds(timer);
+
+    TwoDimensionalPlot plot;
+    QGraphicsView view;
+    view.resize(width, height);
+    plot.setupView(&view);
+    view.show();
+
+    timer.restart();
+    plot.generatePlot("Benchmark", 10, 10, &x, ySet, plotSet());
+    double plotTime = milliseconds(timer);
+
+    timer.restart();
+    plot.fitAllInView();
+    double fit = milliseconds(timer);
+
+    // Grabbing the view paints it synchronously
+    timer.restart();
+    QPixmap pixmap = view.grab();
+    double paint = milliseconds(timer);
+
+    double peak = peakMegabytes();
+
+    printf("%-10s %8d %12zu %10.1f %10.2f %10.2f %12.1f %10.2f %10.1f %10.1f %10.1f\n",
+           monotonic ? "monotonic" : "walk", channels, samples, generate, range, ticks, plotTime, fit, paint, peak, peak - peakBefore);
+    fflush(stdout);
+
+}// runCase
+
+
+/*!
+ * Benchmark TwoDimensionalPlot across channel counts, sample counts, and
+ * monotonic or non-monotonic x data.  All the monotonic cases run before the
+ * first walk case.  The memory high water mark of the process never goes
+ * down, so the peak printed with each row is the largest of any case so far,
+ * and the growth of the peak printed after it is what that case added.
+ */
+int main(int argc, char *argv[])
+{
+    // Render without a display unless the caller picked a platform
+    if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("benchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Scaling benchmark of TwoDimensionalPlot");
+    parser.addHelpOption();
+    QCommandLineOption maxSamplesOption("max-samples", "Largest power of ten samples per channel, 3 to 8.", "power", "8");
+    QCommandLineOption budgetOption("budget", "Skip cases with more than this many total samples.", "samples", "400000000");
+    QCommandLineOption widthOption("width", "Width of the view in pixels.", "pixels", "1200");
+    QCommandLineOption heightOption("height", "Height of the view in pixels.", "pixels", "800");
+    parser.addOption(maxSamplesOption);
+    parser.addOption(budgetOption);
+    parser.addOption(widthOption);
+    parser.addOption(heightOption);
+    parser.process(app);
+
+    int maxPower = parser.value(maxSamplesOption).toInt();
+    if(maxPower < 3)
+        maxPower = 3;
+    else if(maxPower > 8)
+        maxPower = 8;
+
+    double budget = parser.value(budgetOption).toDouble();
+    int width = parser.value(widthOption).toInt();
+    int height = parser.value(heightOption).toInt();
+
+    const int channelCounts[] = {1, 4, 16, 64};
+
+    printf("All times in milliseconds, peak memory in megabytes\n");
+    printf("%-10s %8s %12s %10s %10s %10s %12s %10s %10s %10s %10s\n",
+           "x", "channels", "samples", "makeData", "getRange", "tickMarks", "generatePlot", "fitAll", "firstPaint", "peakMB", "growMB");
+
+    for(int monotonic = 1; monotonic >= 0; monotonic--)
+    {
+        for(int power = 3; power <= maxPower; power++)
+        {
+            size_t samples = 1;
+            for(int p = 0; p < power; p++)
+                samples *= 10;
+
+            for(int channels : channelCounts)
+            {
+                // x plus every channel
+                if((double)samples*(channels + 1) > budget)
+                {
+                    printf("%-10s %8d %12zu skipped, over the budget of samples\n", monotonic ? "monotonic" : "walk", channels, samples);
+                    continue;
+                }
+
+                runCase(channels, samples, monotonic != 0, width, height);
+            }
+        }
+    }
+
+    return 0;
+
+}// main
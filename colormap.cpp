@@ -0,0 +1,86 @@
+#include "colormap.h"
+
+//! Create the default heat map
+ColorMap::ColorMap()
+{
+    *this = heat();
+}
+
+
+/*!
+ * Create a map that blends evenly through a list of colors.  The first color
+ * is entry 0, the last color is entry 255.
+ * \param stops is the list of colors, there should be at least two
+ */
+ColorMap::ColorMap(const QList<QColor> & stops)
+{
+    table.resize(entries);
+
+    if(stops.isEmpty())
+    {
+        table.fill(qRgb(0, 0, 0));
+        return;
+    }
+
+    if(stops.size() == 1)
+    {
+        table.fill(stops.first().rgba());
+        return;
+    }
+
+    int segments = stops.size() - 1;
+    for(int i = 0; i < entries; i++)
+    {
+        // Which pair of stops, and how far between them
+        double position = (double)i*segments/(entries - 1);
+        int segment = (int)position;
+        if(segment >= segments)
+            segment = segments - 1;
+        double blend = position - segment;
+
+        const QColor & low = stops[segment];
+        const QColor & high = stops[segment+1];
+
+        table[i] = qRgba((int)(low.red()   + blend*(high.red()   - low.red())   + 0.5),
+                         (int)(low.green() + blend*(high.green() - low.green()) + 0.5),
+                         (int)(low.blue()  + blend*(high.blue()  - low.blue())  + 0.5),
+                         (int)(low.alpha() + blend*(high.alpha() - low.alpha()) + 0.5));
+    }
+
+}// ColorMap::ColorMap
+
+
+/*!
+ * Find the table entry of a fraction
+ * \param fraction is from 0 to 1, and is clamped to that range.  NaN gives entry 0
+ * \return the index of the table entry, from 0 to 255
+ */
+int ColorMap::index(double fraction)
+{
+    // This also catches NaN
+    if(!(fraction > 0.0))
+        return 0;
+
+    if(fraction >= 1.0)
+        return entries - 1;
+
+    return (int)(fraction*(entries - 1) + 0.5);
+}
+
+
+//! \return the heat map, from dark blue through cyan and yellow to red
+ColorMap ColorMap::heat(void)
+{
+    QList<QColor> stops;
+    stops << QColor(0, 0, 128) << QColor(0, 128, 255) << QColor(0, 255, 255) << QColor(255, 255, 0) << QColor(255, 128, 0) << QColor(255, 0, 0);
+    return ColorMap(stops);
+}
+
+
+//! \return the gray map, from black to white
+ColorMap ColorMap::gray(void)
+{
+    QList<QColor> stops;
+    stops << Qt::black << Qt::white;
+    return ColorMap(stops);
+}
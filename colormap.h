@@ -0,0 +1,48 @@
+#ifndef COLORMAP_H
+#define COLORMAP_H
+
+#include <QColor>
+#include <QList>
+#include <QRgb>
+#include <QVector>
+
+/*!
+ * \brief The ColorMap class is a lookup table from a fraction to a color.
+ *
+ * The table has 256 entries, blended evenly through a list of color stops, so
+ * it can be used directly as the color table of an 8-bit indexed QImage.
+ * Mapping a value to a color is then a single index, rather than blending
+ * colors for every pixel.
+ */
+class ColorMap
+{
+public:
+    //! Create the default heat map
+    ColorMap();
+
+    //! Create a map that blends evenly through a list of colors
+    ColorMap(const QList<QColor> & stops);
+
+    //! \return the color of a fraction from 0 to 1, which is clamped
+    QRgb color(double fraction) const {return table[index(fraction)];}
+
+    //! \return the index of the table entry of a fraction from 0 to 1, which is clamped
+    static int index(double fraction);
+
+    //! \return the 256 colors of the table
+    const QVector<QRgb> & colorTable(void) const {return table;}
+
+    //! \return the heat map, from dark blue through cyan and yellow to red
+    static ColorMap heat(void);
+
+    //! \return the gray map, from black to white
+    static ColorMap gray(void);
+
+    //! Number of entries in the table
+    static const int entries = 256;
+
+protected:
+    QVector<QRgb> table;    //!< The color of each entry
+};
+
+#endif // COLORMAP_H
@@ -0,0 +1,105 @@
+#include "curveitem.h"
+#include <QPen>
+#include <QtNumeric>
+#include <QStyleOptionGraphicsItem>
+
+//! Number of line segments drawn with each call to drawPolyline()
+static const int chunkSegments = 4096;
+
+/*!
+ * Create the item that draws a connected line through a list of points.
+ * \param input is the points of the line, in scene coordinates
+ * \param lineColor is the color of the line
+ * \param parent is the parent item, which can be null
+ */
+CurveItem::CurveItem(const QVector<QPointF> & input, const QColor & lineColor, QGraphicsItem* parent) :
+    QGraphicsItem(parent),
+    points(input),
+    color(lineColor)
+{
+    // The exposed rect is needed to skip chunks that are not drawn
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+
+    // Like QPainterPath::lineTo(), points that are not finite are skipped, and
+    //   the line joins the points on either side of them
+    int good = 0;
+    while((good < points.size()) && qIsFinite(points[good].x()) && qIsFinite(points[good].y()))
+        good++;
+
+    if(good < points.size())
+    {
+        for(int i = good + 1; i < input.size(); i++)
+        {
+            if(qIsFinite(input[i].x()) && qIsFinite(input[i].y()))
+                points[good++] = input[i];
+        }
+
+        points.resize(good);
+    }
+
+    if(points.size() < 2)
+        return;
+
+    // Each chunk shares its first point with the end of the previous chunk
+    for(int first = 0; first < points.size() - 1; first += chunkSegments)
+    {
+        int last = first + chunkSegments;
+        if(last > points.size() - 1)
+            last = points.size() - 1;
+
+        double left = points[first].x();
+        double right = left;
+        double top = points[first].y();
+        double bottom = top;
+        for(int i = first + 1; i <= last; i++)
+        {
+            if(points[i].x() < left)
+                left = points[i].x();
+            else if(points[i].x() > right)
+                right = points[i].x();
+
+            if(points[i].y() < top)
+                top = points[i].y();
+            else if(points[i].y() > bottom)
+                bottom = points[i].y();
+        }
+
+        // Half the pen sticks out past the line
+        QRectF rect = QRectF(QPointF(left, top), QPointF(right, bottom)).adjusted(-0.5, -0.5, 0.5, 0.5);
+        chunkBounds.append(rect);
+        bounds |= rect;
+
+    }// for all chunks
+
+}// CurveItem::CurveItem
+
+
+/*!
+ * Draw the line, one chunk at a time, skipping chunks that are not exposed.
+ * \param painter is the painter to draw with
+ * \param option gives the exposed rectangle
+ * \param widget is not used
+ */
+void CurveItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+    Q_UNUSED(widget);
+
+    if(chunkBounds.isEmpty())
+        return;
+
+    painter->setPen(QPen(color));
+
+    for(int k = 0; k < chunkBounds.size(); k++)
+    {
+        if(!chunkBounds[k].intersects(option->exposedRect))
+            continue;
+
+        int first = k*chunkSegments;
+        int last = first + chunkSegments;
+        if(last > points.size() - 1)
+            last = points.size() - 1;
+
+        painter->drawPolyline(points.constData() + first, last - first + 1);
+    }
+
+}// CurveItem::paint
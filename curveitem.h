@@ -0,0 +1,43 @@
+#ifndef CURVEITEM_H
+#define CURVEITEM_H
+
+#include <QGraphicsItem>
+#include <QColor>
+#include <QPainter>
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+
+/*!
+ * \brief The CurveItem class draws a connected line through a list of points.
+ *
+ * The points are kept in one contiguous array and drawn with drawPolyline(),
+ * rather than a QPainterPath, which stores a larger element per point and is
+ * converted again for stroking. The line is drawn in chunks, and chunks that
+ * are not exposed are skipped. The bounding rect of the whole line and of
+ * every chunk is computed once, when the item is created. Points that are not
+ * finite are dropped, so a gap in the data is bridged by a straight line.
+ */
+class CurveItem : public QGraphicsItem
+{
+public:
+    //! Create the item for a line through points in scene coordinates
+    CurveItem(const QVector<QPointF> & points, const QColor & color, QGraphicsItem* parent = 0);
+
+    //! \return the rectangle that bounds the line
+    virtual QRectF boundingRect(void) const override {return bounds;}
+
+    //! Draw the line
+    virtual void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = 0) override;
+
+    //! \return the number of points in the line
+    int count(void) const {return points.size();}
+
+protected:
+    QVector<QPointF> points;        //!< The points of the line, in order
+    QVector<QRectF> chunkBounds;    //!< Bounds of each chunk of the line
+    QColor color;                   //!< Color of the line
+    QRectF bounds;                  //!< Rectangle that bounds the line
+};
+
+#endif // CURVEITEM_H
@@ -1,4 +1,6 @@
 #include "dialscene.h"
+#include "scalegeometry.h"
+#include <QFontMetricsF>
 #include <QGraphicsTextItem>
 #include <QPen>
 #include <Qt>
@@ -8,6 +10,11 @@ using namespace Qt;
 
 DialScene::DialScene(void) :
     size(200),
+    arcsize(0),
+    arcRect(),
+    dialCenter(),
+    angleScale(0),
+    angleOffset(225),
     lowAngle(225),
     highAngle(-45),
     pointer(),
@@ -117,8 +124,8 @@ void DialScene::buildLowPath(QGraphicsScene& scene)
 
     // The low path, notice that the path is built counterclockwise,
     // so we start at the top and go down in value
-    path.arcMoveTo(rectx, recty, arcsize, arcsize, highangle);
-    path.arcTo(rectx, recty, arcsize, arcsize, highangle, lowangle-highangle);
+    path.arcMoveTo(arcRect, highangle);
+    path.arcTo(arcRect, highangle, lowangle-highangle);
 
     pen.setWidthF(size*arcWidth);
     pen.setColor(lowColor);
@@ -142,8 +149,8 @@ void DialScene::buildOkPath(QGraphicsScene& scene)
     
     // The low path, notice that the path is built counterclockwise,
     // so we start at the top and go down in value
-    path.arcMoveTo(rectx, recty, arcsize, arcsize, highangle);
-    path.arcTo(rectx, recty, arcsize, arcsize, highangle, lowangle-highangle);
+    path.arcMoveTo(arcRect, highangle);
+    path.arcTo(arcRect, highangle, lowangle-highangle);
 
     pen.setWidthF(size*arcWidth);
     pen.setColor(midColor);
@@ -166,8 +173,8 @@ void DialScene::buildHighPath(QGraphicsScene& scene)
 
     // The low path, notice that the path is built counterclockwise,
     // so we start at the top and go down in value
-    path.arcMoveTo(rectx, recty, arcsize, arcsize, highangle);
-    path.arcTo(rectx, recty, arcsize, arcsize, highangle, lowangle-highangle);
+    path.arcMoveTo(arcRect, highangle);
+    path.arcTo(arcRect, highangle, lowangle-highangle);
 
     pen.setWidthF(size*arcWidth);
     pen.setColor(highColor);
@@ -187,32 +194,22 @@ void DialScene::buildMajorTicks(QGraphicsScene& scene)
     if((majorTickMarkLength <= 0.0) || (majorSpacing <= 0.0))
         return;
 
-    double scale = scaleStart;
-    double endScale = scaleStart+getTotalRange();
-    double angle;
-
     double tickLength = size*majorTickMarkLength;
     double offsetLength = 0.5*size*majorTickMarkLength;
+    double radius = 0.5*arcsize - offsetLength;
 
-    QPen pen;
-    QPainterPath path;
-
-    while(scale <= endScale)
-    {
-        angle = scaleToAngle(scale);
-
-        // Go to a location on the elipse
-        path.arcMoveTo(rectx, recty, arcsize, arcsize, angle);
+    // No closer than the minimum pitch along the arc
+    double spacing = spacingForPixels(majorSpacing, getTotalRange(), radius*deg2rad(fabs(angleScale)), minimumTickPitch);
 
-        // Move from that location towards the center
-        path.moveTo(path.currentPosition()+=QPointF(-offsetLength*cos(deg2rad(-angle)), -offsetLength*sin(deg2rad(-angle))));
+    // The directions of all the tick marks in one pass
+    ScaleGeometry geometry;
+    geometry.setAngles(scaleToAngle(scaleStart), angleScale*spacing, ScaleGeometry::steps(scaleStart, scaleStart+getTotalRange(), spacing));
 
-        // Move from that location towards the center
-        path.lineTo(path.currentPosition()+=QPointF(-tickLength*cos(deg2rad(-angle)), -tickLength*sin(deg2rad(-angle))));
+    QPen pen;
+    QPainterPath path;
 
-        // the next tick mark
-        scale += majorSpacing;
-    }
+    // From inside the arc towards the center
+    geometry.addTicks(path, dialCenter, radius, radius - tickLength);
 
     pen.setWidthF(1.0);
     pen.setColor(tickMarkColor);
@@ -230,32 +227,27 @@ void DialScene::buildMinorTicks(QGraphicsScene& scene)
     if((minorTickMarkLength <= 0.0) || (minorSpacing <= 0.0))
         return;
 
-    double scale = scaleStart;
-    double endScale = scaleStart+getTotalRange();
-    double angle;
-
     double tickLength = size*minorTickMarkLength;
     double offsetLength = 0.5*size*majorTickMarkLength;
+    double radius = 0.5*arcsize - offsetLength;
+
+    // No closer than the minimum pitch along the arc.  If that makes the minor
+    //   ticks as coarse as the major ticks they are not drawn at all
+    double pixelsPerUnit = radius*deg2rad(fabs(angleScale));
+    double spacing = spacingForPixels(minorSpacing, getTotalRange(), pixelsPerUnit, minimumTickPitch);
+    double major = spacingForPixels(majorSpacing, getTotalRange(), pixelsPerUnit, minimumTickPitch);
+    if(!drawMinorTicks(spacing, minorSpacing, major))
+        return;
+
+    // The directions of all the tick marks in one pass
+    ScaleGeometry geometry;
+    geometry.setAngles(scaleToAngle(scaleStart), angleScale*spacing, ScaleGeometry::steps(scaleStart, scaleStart+getTotalRange(), spacing));
 
     QPen pen;
     QPainterPath path;
 
-    while(scale <= endScale)
-    {
-        angle = scaleToAngle(scale);
-
-        // Go to a location on the elipse
-        path.arcMoveTo(rectx, recty, arcsize, arcsize, angle);
-
-        // Move from that location towards the center
-        path.moveTo(path.currentPosition()+=QPointF(-offsetLength*cos(deg2rad(-angle)), -offsetLength*sin(deg2rad(-angle))));
-
-        // Move from that location towards the center
-        path.lineTo(path.currentPosition()+=QPointF(-tickLength*cos(deg2rad(-angle)), -tickLength*sin(deg2rad(-angle))));
-
-        // the next tick mark
-        scale += minorSpacing;
-    }
+    // From inside the arc towards the center
+    geometry.addTicks(path, dialCenter, radius, radius - tickLength);
 
     pen.setWidthF(1.0);
     pen.setColor(tickMarkColor);
@@ -355,31 +347,36 @@ void DialScene::buildLabels(QGraphicsScene& scene)
         return;
 
     double scale = scaleStart;
-    double endScale = scaleStart+getTotalRange();
-    double angle;
 
     double tickLength = size*majorTickMarkLength;
     double offsetLength = 0.5*size*majorTickMarkLength;
     double moveLength = offsetLength+tickLength;
 
-    QPainterPath path;
-
     // This move length would be perfect, except there is a lot of extraneous
     //   space in the rect surrounding the text, so take some of it off here
     moveLength -= 0.5*offsetLength;
 
-    while(scale <= endScale)
-    {
-        angle = scaleToAngle(scale);
+    // Labels on major ticks, but far enough apart along the arc that the
+    //   widest number on the scale does not overlap its neighbors
+    QFontMetricsF metrics((QFont()));
+    double widest = metrics.width(QString("%1").arg(scaleStart, 0, 'f', tickMarkPrecision));
+    double top = metrics.width(QString("%1").arg(getTopOfScale(), 0, 'f', tickMarkPrecision));
+    if(top > widest)
+        widest = top;
 
-        QPointF location;
+    double radius = 0.5*arcsize - moveLength;
+    double spacing = spacingForPixels(majorSpacing, getTotalRange(), (0.5*arcsize - offsetLength)*deg2rad(fabs(angleScale)), minimumTickPitch);
+    spacing = spacingForPixels(spacing, getTotalRange(), radius*deg2rad(fabs(angleScale)), widest);
 
-        // Go to a location on the elipse
-        path.arcMoveTo(rectx, recty, arcsize, arcsize, angle);
-        location = path.currentPosition();
+    // The directions of all the labels in one pass
+    ScaleGeometry geometry;
+    geometry.setAngles(scaleToAngle(scaleStart), angleScale*spacing, ScaleGeometry::steps(scaleStart, scaleStart+getTotalRange(), spacing));
 
-        // Move from that location towards the center, to the end of the tick mark
-        location += QPointF(-moveLength*cos(deg2rad(-angle)), -moveLength*sin(deg2rad(-angle)));
+    for(size_t i = 0; i < geometry.count(); i++)
+    {
+        // Go to a location on the elipse, and from there towards the center,
+        //   to the end of the tick mark
+        QPointF location = geometry.point(i, dialCenter, radius);
 
         // the text
         QGraphicsTextItem* item = scene.addText(QString("%1").arg(scale, 0, 'f', tickMarkPrecision), QFont());
@@ -395,95 +392,23 @@ void DialScene::buildLabels(QGraphicsScene& scene)
         location += QPointF(-rect.width()/2, -rect.height()/2);
 
         // Now we want to shift the rect so that the center is not at the end
-        //   of the tick.  We need the offsets from the center to where the ray
-        //   intersects the rect walls
-
-        // The angle from the center to the upper right, lower right, upper left,
-        //   and lower left corners in radians.  From 0 to 2PI
-        double angleLRRect = atan2(-rect.height(), rect.width()) + 2.0*pi;
-        double angleURRect = atan2(rect.height(), rect.width());
-        double angleULRect = atan2(rect.height(), -rect.width());
-        double angleLLRect = atan2(-rect.height(), -rect.width()) + 2.0*pi;
-
-        // The ray angle, in radians from 0.0 to 2PI
-        double anglerad = deg2rad(angle);
-        if(anglerad < 0.0)
-            anglerad += 2.0*pi;
-
-        double xoff = 0.0;
-        double yoff = 0.0;
-        if((anglerad >= angleURRect) && (anglerad < angleULRect))
-        {
-            // Vertical offset is half the height
-            yoff = rect.height()/2;
-
-            // Horizontal offset depends on the ray length to the top of the box
-            xoff = -yoff/tan(anglerad);
-
-        }// if ray goes through the top
-        else if((anglerad >= angleULRect) && (anglerad < angleLLRect))
-        {
-            // Horizontal offset is half the width
-            xoff = rect.width()/2;
-
-            // Vertical offset depends on the ray length to the side of the box
-            yoff = -xoff*tan(anglerad);
-
-        }// else if ray goes through the left side
-        else if((anglerad >= angleLLRect) && (anglerad < angleLRRect))
-        {
-            // Vertical offset is half the height
-            yoff = -rect.height()/2;
-
-            // Horizontal offset depends on the ray length to the top of the box
-            xoff = -yoff/tan(anglerad);
-
-        }// else if ray goes through the bottom
-        else
-        {
-            // Horizontal offset is half the width
-            xoff = -rect.width()/2;
-
-            // Vertical offset depends on the ray length to the side of the box
-            yoff = -xoff*tan(anglerad);
-
-        }// else ray goes through the right side
+        //   of the tick, but the edge of the rect where the ray intersects it
+        location += geometry.labelOffset(i, rect);
 
         // Finally locate the text in the scene
-        item->setPos(location.rx() + xoff, location.ry() + yoff);
+        item->setPos(location);
 
         // Turn this on for some debug action
-        //scene.addRect(location.rx() + xoff, location.ry() + yoff, rect.width(), rect.height());
+        //scene.addRect(location.rx(), location.ry(), rect.width(), rect.height());
 
         // the next tick mark
-        scale += majorSpacing;
+        scale += spacing;
 
-    }// while
+    }// for all labels
 
 }// DialScene::buildLabels
 
 
-/*!
- * Get the coordinates of the center of the dial
- * \return the center coordinates
- */
-QPointF DialScene::getCenterOfDial(void)
-{
-    // Find the center of the arc of averaging the 0 and 180 points
-    QPainterPath path;
-    path.arcMoveTo(rectx, recty, arcsize, arcsize, 0);
-    QPointF center = path.currentPosition();
-    path.arcMoveTo(rectx, recty, arcsize, arcsize, 180);
-
-    // Take the average
-    center += path.currentPosition();
-    center *= 0.5;
-
-    return center;
-
-}// DialScene::getCenterOfDial
-
-
 /*!
  * Construct the polygon that describes the pointer.
  */
@@ -683,19 +608,9 @@ void DialScene::buildReadingLabel(QGraphicsScene& scene)
  */
 double DialScene::scaleToAngle(double scale)
 {
-    // The angles go counterclockwise from -30 to -150 (a range of 240 degrees)
-    // -30 represents the high value, and -150 (or 210) is the low value
-    
-    // The fraction of the range
-    double angle = (scale - scaleStart)/getTotalRange();
-    
-    // Map to angle range, notice inversion
-    angle *= (highAngle - lowAngle);
-    
-    // Starting point offset
-    angle += lowAngle;
-    
-    return angle;
+    // The coefficients are computed with the geometry, the low angle is the
+    //   start of the scale, and the high angle is the top
+    return angleScale*scale + angleOffset;
 
 }// scaleToAngle
 
@@ -712,6 +627,89 @@ double DialScene::scaleRangeToAngleRange(double range)
 }
 
 
+/*!
+ * Compute the geometry of the arc, which is used by everything else in the
+ * scene.  The bounds of the arc, including the width of its pen, are found
+ * from the angles so the arc can be centered in the scene.  The bounds are
+ * the ends of the arc on its inner and outer edges, plus the outer edge at
+ * any of the four compass points that lie between the ends.  This also
+ * computes the coefficients that convert the scale to angle.
+ */
+void DialScene::computeGeometry(void)
+{
+    double radius = 0.5*arcsize;
+    double inner = radius - 0.5*size*arcWidth;
+    double outer = radius + 0.5*size*arcWidth;
+
+    double start = lowAngle;
+    double end = highAngle;
+    if(end < start)
+    {
+        start = highAngle;
+        end = lowAngle;
+    }
+
+    // No more than all the way around
+    if(end > start + 360.0)
+        end = start + 360.0;
+
+    // The ends of the arc, relative to the upper left of the arc rect
+    double minx = 0, maxx = 0, miny = 0, maxy = 0;
+    double ends[4][2] = {{start, inner}, {start, outer}, {end, inner}, {end, outer}};
+    for(int i = 0; i < 4; i++)
+    {
+        double x = radius + ends[i][1]*cos(deg2rad(ends[i][0]));
+        double y = radius - ends[i][1]*sin(deg2rad(ends[i][0]));
+
+        if(i == 0)
+        {
+            minx = maxx = x;
+            miny = maxy = y;
+        }
+
+        minx = (x < minx) ? x : minx;
+        maxx = (x > maxx) ? x : maxx;
+        miny = (y < miny) ? y : miny;
+        maxy = (y > maxy) ? y : maxy;
+    }
+
+    // The compass points between the ends, which are the extremes of the arc
+    for(double angle = 90.0*ceil(start/90.0); angle <= end; angle += 90.0)
+    {
+        // Which compass point, counting counter clockwise from the right
+        int quadrant = ((int)(angle/90.0)) % 4;
+        if(quadrant < 0)
+            quadrant += 4;
+
+        if(quadrant == 0)
+            maxx = radius + outer;
+        else if(quadrant == 1)
+            miny = radius - outer;
+        else if(quadrant == 2)
+            minx = radius - outer;
+        else
+            maxy = radius + outer;
+    }
+
+    // Center the bounds of the arc in the scene
+    double rectx = (scenerect.width() - (maxx - minx))/2 - minx;
+    double recty = (scenerect.height() - (maxy - miny))/2 - miny;
+
+    arcRect = QRectF(rectx, recty, arcsize, arcsize);
+    dialCenter = arcRect.center();
+
+    // The affine conversion from scale to angle, the low angle is the start
+    //   of the scale and the high angle is the top
+    if(getTotalRange() > 0.0)
+        angleScale = (highAngle - lowAngle)/getTotalRange();
+    else
+        angleScale = 0.0;
+
+    angleOffset = lowAngle - angleScale*scaleStart;
+
+}// DialScene::computeGeometry
+
+
 /*!
  * Create the scene, redrawing all elements
  * \param scene will be cleared and then completely rebuilt
@@ -741,28 +739,8 @@ void DialScene::createScene(QGraphicsScene& scene)
     // Margin for the arc
     arcsize = size*(1 - 2*arcWidth);
 
-    // Draw an arc, so we can see what space its going to occupy.
-    // I know this is lame, but its a lot simpler than trying to reverse engineer the arc functions
-    QPainterPath path;
-    QPen pen;
-    pen.setWidthF(size*arcWidth);
-    pen.setColor(Qt::black);
-    pen.setCapStyle((Qt::PenCapStyle)0);
-    path.arcMoveTo(0, 0, arcsize, arcsize, highAngle);
-    path.arcTo(0, 0, arcsize, arcsize, highAngle, lowAngle - highAngle);
-    QGraphicsItem* item = scene.addPath(path, pen);
-
-    // Get the size of the item
-    QRectF bound = item->boundingRect();
-
-    // Done with this, don't let it pollute our scene
-    scene.removeItem(item);
-
-    // If the bounding rectangle of the arc does not match the scene we need to recenter it
-    rectx = (scenerect.width() - bound.width())/2;
-    recty = (scenerect.height() - bound.height())/2;
-    rectx -= bound.x();
-    recty -= bound.y();
+    // Where the arc goes, and the mapping from scale to angle
+    computeGeometry();
 
     // Build the arcs
     buildHighPath(scene);
@@ -60,7 +60,11 @@ private: // methods
     void placePointer(QGraphicsScene& scene);
     double scaleToAngle(double scale);
     double scaleRangeToAngleRange(double range);
-    QPointF getCenterOfDial(void);
+    void computeGeometry(void);
+
+    //! \return the center of the dial, computed when the scene is created
+    QPointF getCenterOfDial(void) const {return dialCenter;}
+
     void buildReadingLabel(QGraphicsScene& scene); 
     void updateReading(QGraphicsScene& scene);
 
@@ -68,8 +72,10 @@ private:    // properties
     QRect scenerect;
     double size;                //!< The size of the rectangle that contains the arc
     double arcsize;             //!< The size of the arc
-    double rectx;               //!< The x position of the arc drawing rect
-    double recty;               //!< The y position of the arc drawing rect
+    QRectF arcRect;             //!< The rect that bounds the arc, centered in the scene
+    QPointF dialCenter;         //!< The center of the arc
+    double angleScale;          //!< Degrees of arc per user unit
+    double angleOffset;         //!< Angle of a reading of zero, in degrees
     double lowAngle;            //!< The angle of the arc that represents the bottom of the scale
     double highAngle;           //!< The angle of the arc that represents the top of the scale
     QPolygonF pointer;          //!< The pointer shape
@@ -1,4 +1,5 @@
 #include "gauge.h"
+#include <math.h>
 
 Gauge::Gauge(void) :
     scaleStart(0.0),
@@ -295,6 +296,72 @@ double Gauge::getTopOfScale(void) const
 }
 
 
+/*!
+ * Coarsen a tick mark or label spacing for the size of the gauge on the
+ * screen.  If the spacing would put ticks closer than the minimum pitch, or
+ * produce more than maximumTicks over the range, it is multiplied by the
+ * smallest of 2, 5, 10, 20, 50, 100, and so on, that fixes both.  The
+ * coarser ticks still land on ticks of the configured spacing.
+ * \param spacing is the configured spacing in users units
+ * \param range is the range in users units that the ticks are drawn over
+ * \param pixelsPerUnit is the number of pixels on the screen per users unit,
+ *        or 0 if unknown, in which case only the number of ticks is limited
+ * \param minimumPitch is the fewest pixels allowed between ticks
+ * \return the spacing to use, which is spacing if it is already good, or 0
+ *          if spacing is 0 or less
+ */
+double Gauge::spacingForPixels(double spacing, double range, double pixelsPerUnit, double minimumPitch)
+{
+    if(spacing <= 0.0)
+        return 0.0;
+
+    // The smallest multiple of the spacing that meets both limits
+    double multiple = 1.0;
+
+    if(pixelsPerUnit > 0.0)
+        multiple = minimumPitch/(spacing*pixelsPerUnit);
+
+    if(fabs(range)/(spacing*maximumTicks) > multiple)
+        multiple = fabs(range)/(spacing*maximumTicks);
+
+    if(!(multiple > 1.0))
+        return spacing;
+
+    // Round up to the next 1, 2, 5 times a power of 10
+    double decade = pow(10.0, floor(log10(multiple)));
+    if(multiple <= decade)
+        multiple = decade;
+    else if(multiple <= 2.0*decade)
+        multiple = 2.0*decade;
+    else if(multiple <= 5.0*decade)
+        multiple = 5.0*decade;
+    else
+        multiple = 10.0*decade;
+
+    return spacing*multiple;
+
+}// Gauge::spacingForPixels
+
+
+/*!
+ * Decide if the minor ticks should be drawn after their spacing has been
+ * coarsened by spacingForPixels().  Minor ticks that were not coarsened are
+ * always drawn.  Minor ticks that were coarsened to the major spacing or
+ * beyond would only draw over the major ticks, so they are not drawn.
+ * \param minor is the coarsened minor spacing
+ * \param minorSpacing is the configured minor spacing
+ * \param major is the coarsened major spacing
+ * \return true if the minor ticks should be drawn
+ */
+bool Gauge::drawMinorTicks(double minor, double minorSpacing, double major)
+{
+    if(minor <= 0.0)
+        return false;
+
+    return (minor == minorSpacing) || (minor < major);
+}
+
+
 /*!
  * Given a rect that bounds an item, return a location offset such that when
  * passed to QGraphicsScene->setPos() the location is with respect to the rect center
@@ -181,6 +181,12 @@ protected: // methods
     //! Create the entire scene
     virtual void createScene(QGraphicsScene& scene) = 0;
 
+    //! Coarsen a tick mark or label spacing so they are far enough apart on the screen, and not too many
+    static double spacingForPixels(double spacing, double range, double pixelsPerUnit, double minimumPitch);
+
+    //! \return true if minor ticks at a coarsened spacing are still worth drawing between the major ticks
+    static bool drawMinorTicks(double minor, double minorSpacing, double major);
+
     //! location is with respect to the rect center
     QPointF rectOffsetForCenter(const QRectF rect) const;
 
@@ -209,6 +215,9 @@ protected: // methods
     QPointF rectOffsetForRightCenter(const QRectF rect) const;
 
 protected:    // properties
+    static const int minimumTickPitch = 3;  //!< The fewest pixels between tick marks
+    static const int maximumTicks = 4096;   //!< The most tick marks or labels of one spacing in a scene
+
     double scaleStart;          //!< The value at the bottom of the gauge scale
     double scaleLowRange;       //!< The range of the low range of the scale
     double scaleMidRange;       //!< The range of the Mid range of the scale
@@ -6,7 +6,7 @@
 
 QT       += core gui
 
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets concurrent
 
 TARGET = gauges
 TEMPLATE = app
@@ -16,22 +16,47 @@ QMAKE_CXXFLAGS += -Wno-unused-parameter
 SOURCES += main.cpp\
         dialog.cpp \
     attitudescene.cpp \
+    barbankgauge.cpp \
+    colormap.cpp \
+    curveitem.cpp \
     dialscene.cpp \
     gauge.cpp \
     lineargaugescene.cpp \
     lineargaugescene2.cpp \
+    minmaxpyramid.cpp \
+    plothover.cpp \
+    scalegeometry.cpp \
+    scatteritem.cpp \
+    stripchartplot.cpp \
+    tapegaugescene.cpp \
+    tiffstripwriter.cpp \
     twodimensionalplot.cpp \
-    twodimensionalscene.cpp
+    twodimensionalscene.cpp \
+    waterfallitem.cpp \
+    waterfallplot.cpp
 
 HEADERS  += dialog.h \
     attitudescene.h \
+    barbankgauge.h \
+    colormap.h \
+    curveitem.h \
     dialscene.h \
     gauge.h \
+    lineargaugeaxis.h \
     lineargaugescene.h \
     lineargaugescene2.h \
+    minmaxpyramid.h \
+    plothover.h \
     qgraphicsviewnoscroll.h \
+    scalegeometry.h \
+    scatteritem.h \
+    stripchartplot.h \
+    tapegaugescene.h \
+    tiffstripwriter.h \
     twodimensionalplot.h \
-    twodimensionalscene.h
+    twodimensionalscene.h \
+    waterfallitem.h \
+    waterfallplot.h
 
 FORMS    += dialog.ui
 
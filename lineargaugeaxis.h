@@ -0,0 +1,67 @@
+#ifndef LINEARGAUGEAXIS_H
+#define LINEARGAUGEAXIS_H
+
+#include <QPointF>
+#include <QRect>
+#include <QRectF>
+
+/*!
+ * \brief The linearAxis class maps the axes of a linear gauge to the scene.
+ *
+ * A linear gauge is laid out in two directions: along the scale, and across
+ * it. For a horizontal gauge along is x and across is y. For a vertical gauge
+ * along is y, with the start of the scale at the bottom, and across is x. Code
+ * written in terms of along and across, and templated on the orientation,
+ * serves both orientations with no runtime test of the orientation.
+ */
+template<bool horizontal> class linearAxis;
+
+
+//! The axes of a horizontal gauge, along is x and across is y
+template<> class linearAxis<true>
+{
+public:
+    //! \return the length of the gauge along the scale
+    static double length(const QRect & size) {return size.width();}
+
+    //! \return the breadth of the gauge across the scale
+    static double breadth(const QRect & size) {return size.height();}
+
+    //! \return the pixel location of a fraction of the scale
+    static double toPixel(double fraction, const QRect & size) {return fraction*size.width();}
+
+    //! \return the scene point of an along and across location
+    static QPointF point(double along, double across) {return QPointF(along, across);}
+
+    //! \return the scene rect from along location a to b, and across from start for breadth
+    static QRectF span(double a, double b, double start, double breadth)
+    {
+        return (a < b) ? QRectF(a, start, b - a, breadth) : QRectF(b, start, a - b, breadth);
+    }
+};
+
+
+//! The axes of a vertical gauge, along is y from the bottom up and across is x
+template<> class linearAxis<false>
+{
+public:
+    //! \return the length of the gauge along the scale
+    static double length(const QRect & size) {return size.height();}
+
+    //! \return the breadth of the gauge across the scale
+    static double breadth(const QRect & size) {return size.width();}
+
+    //! \return the pixel location of a fraction of the scale, vertical pixels are reversed
+    static double toPixel(double fraction, const QRect & size) {return size.height() - fraction*size.height();}
+
+    //! \return the scene point of an along and across location
+    static QPointF point(double along, double across) {return QPointF(across, along);}
+
+    //! \return the scene rect from along location a to b, and across from start for breadth
+    static QRectF span(double a, double b, double start, double breadth)
+    {
+        return (a < b) ? QRectF(start, a, breadth, b - a) : QRectF(start, b, breadth, a - b);
+    }
+};
+
+#endif // LINEARGAUGEAXIS_H
@@ -1,6 +1,8 @@
 #include "lineargaugescene.h"
+#include <QGraphicsRectItem>
 #include <QGraphicsTextItem>
 #include <limits>
+#include <math.h>
 
 LinearGaugeScene::LinearGaugeScene(void) :
     textReading2(0),
@@ -13,8 +15,12 @@ LinearGaugeScene::LinearGaugeScene(void) :
     ticksBothSides(false),
     size(),
     rectItem(0),
-    readingTextItem(0)
+    fillItem(0),
+    fillItem2(0),
+    readingTextItem(0),
+    readingAlignment(Qt::AlignCenter)
 {
+    selectOrientation();
 }
 
 
@@ -185,127 +191,145 @@ void LinearGaugeScene::setDualReadings(double pointerValue, double textValue, do
  */
 void LinearGaugeScene::updateReading(QGraphicsScene& scene)
 {
-    buildRect(scene);
+    (this->*rectUpdater)();
     buildReadingLabel(scene);
 }
 
 
 /*!
- * Build the rects that describes the two readings
- * \param scene receives the rects
+ * Build the rects that describe the two readings.  This is only done when the
+ * scene is created, updateRectT() moves and colors them for each reading.
+ * \param scene receives the rects.  The caller must make sure that the
+ *        previous rects have been removed from the scene.
  */
 void LinearGaugeScene::buildRect(QGraphicsScene& scene)
 {
-    QColor color = getColorFromReading(gaugeReading);
-    QBrush brush = QBrush(color);
-    QPen pen = QPen(color);
+    // This is a border rect which is needed to make sure the view is scaling
+    //   the whole picture, even if the current reading does not extend that
+    //   far.  It also provides color data, even when the reading is zero
+    rectItem = scene.addRect(0, 0, size.width(), size.height(), QPen(Qt::NoPen), QBrush());
+
+    // The gauge rects, which are filled in as far as needed to display the readings
+    fillItem = scene.addRect(QRectF(), QPen(Qt::NoPen), QBrush());
+    fillItem2 = scene.addRect(QRectF(), QPen(Qt::NoPen), QBrush());
+
+    // Needs to be under everything else
+    rectItem->setZValue(-10.0);
+    fillItem->setZValue(-10.0);
+    fillItem2->setZValue(-11.0);
+
+    // Treat these rects as one item
+    fillItem->setParentItem(rectItem);
+    fillItem2->setParentItem(rectItem);
+
+    // Force the colors to be set by the first update
+    borderColor = fillColor = fillColor2 = QColor();
+
+}// LinearGaugeScene::buildRect
+
+
+/*!
+ * Set the pen and brush of a rect to a color, one pixel wide.  Nothing is done
+ * if the color has not changed, which is the usual case.
+ * \param item is the rect to color
+ * \param color is the new color
+ * \param current is the color the rect has now, and is updated
+ * \param fill should be true to fill the rect, false for just the border
+ */
+static void setRectColor(QGraphicsRectItem* item, const QColor& color, QColor& current, bool fill)
+{
+    if(color == current)
+        return;
+
+    current = color;
 
     // One pixel wide
+    QPen pen(color);
     pen.setWidthF(1);
+    item->setPen(pen);
 
-    // Remove the old first rect
-    if(rectItem)
-    {
-        scene.removeItem(rectItem);
-        delete rectItem;
-        rectItem = 0;
-    }
+    if(fill)
+        item->setBrush(QBrush(color));
+}
+
+
+/*!
+ * Move and color the rects that describe the two readings.  The rects are
+ * only resized, and only change color when a reading changes band.  This is
+ * templated on the orientation and on dual values, so the version for this
+ * gauge has no tests of either, see selectOrientation().
+ */
+template<bool horizontal, bool dual> void LinearGaugeScene::updateRectT(void)
+{
+    typedef linearAxis<horizontal> axis;
+
+    if(rectItem == 0)
+        return;
 
     double from;
     if((drawFrom > scaleStart) && (drawFrom < getTopOfScale()))
-        from = scaleToPixel(drawFrom);
+        from = scaleToPixelT<horizontal>(drawFrom);
     else
-        from = scaleToPixel(scaleStart);
+        from = scaleToPixelT<horizontal>(scaleStart);
+
+    QColor color = getColorFromReading(gaugeReading);
+    double signal = scaleToPixelT<horizontal>(gaugeReading);
+    double breadth = axis::breadth(size);
 
-    QGraphicsRectItem* item = 0;
-    double signal = scaleToPixel(gaugeReading);
+    setRectColor(fillItem, color, fillColor, true);
 
-    if(dualvalue)
+    if(dual)
     {
         QColor color2 = getColorFromReading(gaugeReading2);
-        QBrush brush2 = QBrush(color2);
-        QPen pen2 = QPen(color2);
+        double signal2 = scaleToPixelT<horizontal>(gaugeReading2);
 
         // A 50/50 blend of both colors
         QColor blended = QColor((color.red()+color2.red())/2, (color.green()+color2.green())/2, (color.blue()+color2.blue())/2);
 
-        // One pixel wide
-        pen2.setWidthF(1);
-
-        double signal2 = scaleToPixel(gaugeReading2);
-        QGraphicsRectItem* item2 = 0;
+        setRectColor(rectItem, blended, borderColor, false);
+        setRectColor(fillItem2, color2, fillColor2, true);
 
-        // This is a border rect which is needed to make sure the view is scaling
-        //   the whole picture, even if the current reading does not extend that
-        //   far.  It also provides color data, even when the reading is zero
-        rectItem = scene.addRect(0, 0, size.width(), size.height(), QPen(blended), QBrush());
-
-        // Now draw the gauge rect, which is filled in as far as needed to display the reading
-        if(horizontal)
-        {
-            if(from < signal)
-                item = scene.addRect(from, 0, signal-from, size.height()/2, pen, brush);
-            else
-                item = scene.addRect(signal2, 0, from-signal, size.height()/2, pen, brush);
-
-            if(from < signal2)
-                item2 = scene.addRect(from, size.height()/2, signal2-from, size.height(), pen2, brush2);
-            else
-                item2 = scene.addRect(signal2, size.height()/2, from-signal2, size.height(), pen2, brush2);
-        }
-        else
-        {
-            // Y axis is reversed (0 on top, positive downward)
-            if(from < signal)
-                item = scene.addRect(0, from, size.width()/2, signal-from, pen, brush);
-            else
-                item = scene.addRect(0, signal, size.width()/2, from - signal, pen, brush);
-
-            if(from < signal2)
-                item2 = scene.addRect(size.width()/2, from, size.width(), signal2-from, pen2, brush2);
-            else
-                item2 = scene.addRect(size.width()/2, signal2, size.width(), from - signal2, pen2, brush2);
-        }
-
-        // Needs to be under everything else
-        item2->setZValue(-11.0);
-        item2->setParentItem(rectItem);
-
-    }// if dual valued
+        // Each reading gets half of the gauge
+        double half = (int)breadth/2;
+        fillItem->setRect(axis::span(from, signal, 0, half));
+        fillItem2->setRect(axis::span(from, signal2, half, breadth - half));
+        fillItem2->setVisible(true);
+    }
     else
     {
-        // This is a border rect which is needed to make sure the view is scaling
-        //   the whole picture, even if the current reading does not extend that
-        //   far.  It also provides color data, even when the reading is zero
-        rectItem = scene.addRect(0, 0, size.width(), size.height(), pen, QBrush());
+        setRectColor(rectItem, color, borderColor, false);
 
-        // Now draw the gauge rect, which is filled in as far as needed to display the reading
-        if(horizontal)
-        {
-            if(from < signal)
-                item = scene.addRect(from, 0, signal-from, size.height(), pen, brush);
-            else
-                item = scene.addRect(signal, 0, from-signal, size.height(), pen, brush);
-        }
-        else
-        {
-            // Y axis is reversed (0 on top, positive downward)
-            if(from < signal)
-                item = scene.addRect(0, from, size.width(), signal-from, pen, brush);
-            else
-                item = scene.addRect(0, signal, size.width(), from - signal, pen, brush);
-        }
+        fillItem->setRect(axis::span(from, signal, 0, breadth));
+        fillItem2->setVisible(false);
+    }
 
-    }// else single values
+}// LinearGaugeScene::updateRectT
 
-    // Needs to be under everything else
-    item->setZValue(-10.0);
-    rectItem->setZValue(-10.0);
 
-    // Treat these two rects as one item
-    item->setParentItem(rectItem);
+/*!
+ * Choose the versions of the per reading functions that match the orientation
+ * and dual values, so they are not tested for every reading.  This is done
+ * when the scene is created, since a change of orientation makes the scene
+ * dirty, and when dual values are turned on or off.
+ */
+void LinearGaugeScene::selectOrientation(void)
+{
+    if(horizontal)
+        rectUpdater = dualvalue ? &LinearGaugeScene::updateRectT<true, true> : &LinearGaugeScene::updateRectT<true, false>;
+    else
+        rectUpdater = dualvalue ? &LinearGaugeScene::updateRectT<false, true> : &LinearGaugeScene::updateRectT<false, false>;
+}
 
-}// LinearGaugeScene::buildRect
+
+/*!
+ * Set if the gauge displays two values or just one (the default)
+ * \param dual should be true to display two values
+ */
+void LinearGaugeScene::setDualValue(bool dual)
+{
+    dualvalue = dual;
+    selectOrientation();
+}
 
 
 /*!
@@ -322,10 +346,13 @@ void LinearGaugeScene::buildMajorTicks(QGraphicsScene& scene)
     QPen pen;
     QPainterPath path;
 
+    // No closer than the minimum pitch on the screen
+    double spacing = spacingForPixels(majorSpacing, tickRange(), scaleRangeToPixelRange(1.0), minimumTickPitch);
+
     if(horizontal)
-        buildHorizontalTicks(path, majorTickMarkLength, majorSpacing);
+        buildTicks<true>(path, majorTickMarkLength, spacing);
     else
-        buildVerticalTicks(path, majorTickMarkLength, majorSpacing);
+        buildTicks<false>(path, majorTickMarkLength, spacing);
 
     pen.setWidthF(1.5);
     pen.setColor(tickMarkColor);
@@ -347,10 +374,17 @@ void LinearGaugeScene::buildMinorTicks(QGraphicsScene& scene)
     QPen pen;
     QPainterPath path;
 
+    // No closer than the minimum pitch on the screen.  If that makes the
+    //   minor ticks as coarse as the major ticks they are not drawn at all
+    double spacing = spacingForPixels(minorSpacing, tickRange(), scaleRangeToPixelRange(1.0), minimumTickPitch);
+    double major = spacingForPixels(majorSpacing, tickRange(), scaleRangeToPixelRange(1.0), minimumTickPitch);
+    if(!drawMinorTicks(spacing, minorSpacing, major))
+        return;
+
     if(horizontal)
-        buildHorizontalTicks(path, minorTickMarkLength, minorSpacing);
+        buildTicks<true>(path, minorTickMarkLength, spacing);
     else
-        buildVerticalTicks(path, minorTickMarkLength, minorSpacing);
+        buildTicks<false>(path, minorTickMarkLength, spacing);
 
     pen.setWidthF(1.0);
     pen.setColor(tickMarkColor);
@@ -358,87 +392,51 @@ void LinearGaugeScene::buildMinorTicks(QGraphicsScene& scene)
 }
 
 /*!
- * Build and add the path for the major horizontal tickmarks of the scale
+ * Build and add the path for the tickmarks of the scale, across the scale at
+ * each spacing along it
  * \param path is updated with the tickmarks.
  * \param tickLength is the length of the tickmarks as a fraction of the size.
  * \param spacing is spacing between ticks.
  */
-void LinearGaugeScene::buildHorizontalTicks(QPainterPath& path, double tickLength, double spacing)
+template<bool horizontal> void LinearGaugeScene::buildTicks(QPainterPath& path, double tickLength, double spacing)
 {
-    double scale = scaleStart;
-    double endScale = scaleStart+getTotalRange();
+    typedef linearAxis<horizontal> axis;
 
-    tickLength = size.height()*tickLength;
-
-    while(scale <= endScale)
-    {
-        double pixel = scaleToPixel(scale);
-
-        // don't step on outside border
-        if((pixel > 0) && (pixel < size.width()))
-        {
-            // In both sides there is no "right or bottom" we do both
-            if(ticksRightOrBottom || ticksBothSides)
-            {
-                // Draw vertical line from bottom up
-                path.moveTo(pixel, size.height()-1);
-                path.lineTo(pixel, size.height()-tickLength-1);
-            }
-
-            if(!ticksRightOrBottom || ticksBothSides)
-            {
-                // Draw vertical line from top down
-                path.moveTo(pixel, 1);
-                path.lineTo(pixel, tickLength - 1);
-            }
-        }
-
-        // the next tick mark
-        scale += spacing;
-    }
-}
-
-
-/*!
- * Build and add the path for the horizontal tickmarks of the scale, arrayed vertically
- * \param path is updated with the tickmarks.
- * \param tickLength is the length of the tickmarks as a fraction of the size.
- * \param spacing is spacing between ticks.
- */
-void LinearGaugeScene::buildVerticalTicks(QPainterPath& path, double tickLength, double spacing)
-{
     double scale = scaleStart;
     double endScale = scaleStart+getTotalRange();
+    double length = axis::length(size);
+    double breadth = axis::breadth(size);
 
-    tickLength = size.width()*tickLength;
+    tickLength = breadth*tickLength;
 
     while(scale <= endScale)
     {
-        double pixel = scaleToPixel(scale);
+        double pixel = scaleToPixelT<horizontal>(scale);
 
         // don't step on outside border
-        if((pixel > 0) && (pixel < size.height()))
+        if((pixel > 0) && (pixel < length))
         {
             // In both sides there is no "right or bottom" we do both
             if(ticksRightOrBottom || ticksBothSides)
             {
-                // Draw horizontal line from right side to the left
-                path.moveTo(size.width()-1, pixel);
-                path.lineTo(size.width()-tickLength-1, pixel);
+                // From the right or bottom side in
+                path.moveTo(axis::point(pixel, breadth-1));
+                path.lineTo(axis::point(pixel, breadth-tickLength-1));
             }
 
             if(!ticksRightOrBottom || ticksBothSides)
             {
-                // Draw horizontal line, from left side to the right
-                path.moveTo(1, pixel);
-                path.lineTo(tickLength+1, pixel);
+                // From the left or top side in
+                path.moveTo(axis::point(pixel, 1));
+                path.lineTo(axis::point(pixel, tickLength+1));
             }
         }
 
         // the next tick mark
         scale += spacing;
     }
-}
+
+}// LinearGaugeScene::buildTicks
 
 
 /*!
@@ -455,6 +453,20 @@ void LinearGaugeScene::buildLabels(QGraphicsScene& scene)
     double scale = scaleStart;
     double endScale = scaleStart+getTotalRange();
 
+    // Labels on major ticks, but far enough apart that they do not overlap.
+    //   Horizontal labels are as wide as the widest number on the scale
+    QFontMetricsF metrics((QFont()));
+    double pitch = metrics.height();
+    if(horizontal)
+    {
+        double widest = metrics.width(QString("%1").arg(scaleStart, 0, 'f', tickMarkPrecision));
+        double top = metrics.width(QString("%1").arg(endScale, 0, 'f', tickMarkPrecision));
+        pitch = ((top > widest) ? top : widest) + 4.0;
+    }
+
+    double tickSpacing = spacingForPixels(majorSpacing, tickRange(), scaleRangeToPixelRange(1.0), minimumTickPitch);
+    double spacing = spacingForPixels(tickSpacing, tickRange(), scaleRangeToPixelRange(1.0), pitch);
+
     double tickLength;
     if(horizontal)
         tickLength = size.height()*majorTickMarkLength;
@@ -539,7 +551,7 @@ void LinearGaugeScene::buildLabels(QGraphicsScene& scene)
         //scene.addRect(location.rx() + xoff, location.ry() + yoff, rect.width(), rect.height());
 
         // the next tick mark
-        scale += majorSpacing;
+        scale += spacing;
 
     }// while
 
@@ -547,142 +559,146 @@ void LinearGaugeScene::buildLabels(QGraphicsScene& scene)
 
 
 /*!
- * Build the label in the scene
- * \param scene is updated with the label.  The caller must make sure that
- *        the previous label has been removed from the scene.
+ * Compute where the reading label goes.  This only depends on the geometry and
+ * the tick marks, so it is done when the scene is created rather than for
+ * every reading.  The label text item itself is created with the first reading.
  */
-void LinearGaugeScene::buildReadingLabel(QGraphicsScene& scene)
+void LinearGaugeScene::layoutReadingLabel(void)
 {
-    if(readingTextItem)
-    {
-        scene.removeItem(readingTextItem);
-        delete readingTextItem;
-        readingTextItem = 0;
-    }
-
-    if(textEnable == false)
-      return;
-
-    QString text = QString("%1").arg(textReading, 0, 'f', readingPrecision);
-
-    if(dualvaluelabel)
-        text += QString(" : %1").arg(textReading2, 0, 'f', readingPrecision);
-
-    // Halfway along the scale
-    double halfScale = (getTopOfScale()+scaleStart)*0.5;
-
-    // Add the text
-    readingTextItem = scene.addText(text, QFont());
-    readingTextItem->setDefaultTextColor(textReadingColor);
-
-    QPointF location;
-
-    // Get the location information of the text
-    // The size of the text, currently the text is located at 0, 0 in the
-    //   scene.  0, 0 refers to the upper left corner of the bounding
-    //   rectangle of the text
-    QRectF rect = readingTextItem->boundingRect();
+    // Does not exist now, and the sizes of the text may have changed with the scene
+    readingTextItem = 0;
+    readingText.clear();
+    readingRects.clear();
 
     // The label location depends on the tick mark location.  If there are no
     //   tick marks, then the label is centered (left to right for vertical
     //   displays and top to bottom for horizontal displays).  If there are
     //   tick marks then the text is offset away from the tick marks
-    if(horizontal)
+    if((majorSpacing > 0.0) && (majorTickMarkLength > 0.0))
     {
-        // Horizonal lay out
-        if((majorSpacing > 0.0) && (majorTickMarkLength > 0.0))
-        {
-            // Tick marks are being drawn
-
-            // Find the major ticks related to half scale
-            double scale = scaleStart;
-            while(scale < halfScale)
-                scale += majorSpacing;
+        // Halfway along the scale
+        double halfScale = (getTopOfScale()+scaleStart)*0.5;
 
-            // now scale is at halfScale, or just past it, back up half the major spacing
-            scale -= 0.5*majorSpacing;
+        // Find the first major tick at or past half scale, then back up half
+        //   the major spacing, so the label is between major tick marks
+        double steps = ceil((halfScale - scaleStart)/majorSpacing);
+        if(steps < 0.0)
+            steps = 0.0;
 
-            // X location is between major tick marks
-            location.setX(scaleToPixel(scale));
+        double scale = scaleStart + steps*majorSpacing - 0.5*majorSpacing;
 
+        if(horizontal)
+        {
             if(ticksRightOrBottom)
             {
                 // Ticks on bottom, so text on top
-                location.setY(0);
-
-                location += rectOffsetForTopCenter(rect);
+                readingAnchor = QPointF(scaleToPixel(scale), 0);
+                readingAlignment = Qt::AlignTop | Qt::AlignHCenter;
             }
             else
             {
                 // Ticks on top, so text on bottom
-                location.setY(size.height());
-
-                location += rectOffsetForBottomCenter(rect);
+                readingAnchor = QPointF(scaleToPixel(scale), size.height());
+                readingAlignment = Qt::AlignBottom | Qt::AlignHCenter;
             }
-
-        }// with tick marks
+        }
         else
         {
-            // No ticks marks, text centered
-
-            // X and Y location is halfway
-            location.setX(size.width()/2);
-            location.setY(size.height()/2);
-
-            // Offset for the text rectangle.  0, 0 is the upper left corner.
-            location += rectOffsetForCenter(rect);
-
-        }// no tickmarks
+            if(ticksRightOrBottom)
+            {
+                // Ticks on right, so text on left
+                readingAnchor = QPointF(0, scaleToPixel(scale));
+                readingAlignment = Qt::AlignLeft | Qt::AlignVCenter;
+            }
+            else
+            {
+                // Ticks on left, so text on right
+                readingAnchor = QPointF(size.width(), scaleToPixel(scale));
+                readingAlignment = Qt::AlignRight | Qt::AlignVCenter;
+            }
+        }
 
-    }// horizontal
+    }// with tick marks
     else
     {
-        // Vertical lay out
-        if((majorSpacing > 0.0) && (majorTickMarkLength > 0.0))
-        {
-            // Tick marks are being drawn
+        // No ticks marks, text centered
+        readingAnchor = QPointF(size.width()/2, size.height()/2);
+        readingAlignment = Qt::AlignCenter;
+    }
 
-            // Find the major ticks related to half scale
-            double scale = scaleStart;
-            while(scale < halfScale)
-                scale += majorSpacing;
+}// LinearGaugeScene::layoutReadingLabel
 
-            // now scale is at halfScale, or just past it, back up half the major spacing
-            scale -= 0.5*majorSpacing;
 
-            // Y location is between major tick marks
-            location.setY(scaleToPixel(scale));
+/*!
+ * Update the label in the scene.  The text item is kept from one reading to
+ * the next, and only changes when the text changes.  The size of the text is
+ * cached by its pattern, the text with every digit replaced by '0', since the
+ * digits are all the same width but signs, points, and separators are not.
+ * \param scene is updated with the label.
+ */
+void LinearGaugeScene::buildReadingLabel(QGraphicsScene& scene)
+{
+    if(textEnable == false)
+    {
+        if(readingTextItem)
+            readingTextItem->setVisible(false);
+        return;
+    }
 
-            if(ticksRightOrBottom)
-            {
-                // Ticks on right, so text on left
-                location.setX(0);
+    QString text = QString("%1").arg(textReading, 0, 'f', readingPrecision);
 
-                location += rectOffsetForLeftCenter(rect);
-            }
-            else
-            {
-                // Ticks on left, so text on right
-                location.setX(size.width());
+    if(dualvaluelabel)
+        text += QString(" : %1").arg(textReading2, 0, 'f', readingPrecision);
 
-                location += rectOffsetForRightCenter(rect);
-            }
+    if(readingTextItem == 0)
+    {
+        readingTextItem = scene.addText(QString(), QFont());
+        readingText.clear();
+    }
 
-        }// with tickmarks
-        else
-        {
-            // No ticks marks, text centered
+    readingTextItem->setVisible(true);
+
+    if(readingTextItem->defaultTextColor() != textReadingColor)
+        readingTextItem->setDefaultTextColor(textReadingColor);
 
-            // X and Y location is halfway
-            location.setX(size.width()/2);
-            location.setY(size.height()/2);
+    if(text == readingText)
+        return;
 
-            // Offset for the text rectangle.  0, 0 is the upper left corner.
-            location += rectOffsetForCenter(rect);
+    readingText = text;
+    readingTextItem->setPlainText(text);
 
-        }// no tickmarks
+    // The size of the text, the text item is located at its upper left corner.
+    //   Digits all have the same width, but other characters do not, so texts
+    //   with the same characters other than the digits have the same size
+    QString pattern = text;
+    for(int i = 0; i < pattern.length(); i++)
+    {
+        if(pattern.at(i).isDigit())
+            pattern[i] = QChar('0');
+    }
 
-    }// vertical
+    QHash<QString, QRectF>::const_iterator cached = readingRects.constFind(pattern);
+    QRectF rect;
+    if(cached == readingRects.constEnd())
+    {
+        rect = readingTextItem->boundingRect();
+        readingRects.insert(pattern, rect);
+    }
+    else
+        rect = cached.value();
+
+    QPointF location = readingAnchor;
+
+    if(readingAlignment == (Qt::AlignTop | Qt::AlignHCenter))
+        location += rectOffsetForTopCenter(rect);
+    else if(readingAlignment == (Qt::AlignBottom | Qt::AlignHCenter))
+        location += rectOffsetForBottomCenter(rect);
+    else if(readingAlignment == (Qt::AlignLeft | Qt::AlignVCenter))
+        location += rectOffsetForLeftCenter(rect);
+    else if(readingAlignment == (Qt::AlignRight | Qt::AlignVCenter))
+        location += rectOffsetForRightCenter(rect);
+    else
+        location += rectOffsetForCenter(rect);
 
     // Now set the position of the text
     readingTextItem->setPos(location);
@@ -697,30 +713,30 @@ void LinearGaugeScene::buildReadingLabel(QGraphicsScene& scene)
  */
 double LinearGaugeScene::scaleToPixel(double scale)
 {
-    // Make sure in bounds
-    if(scale < scaleStart)
-        scale = scaleStart;
-    else if(scale > scaleStart + getTotalRange())
-        scale = scaleStart + getTotalRange();
-
-    // The pixel location within the scene
-    // The fraction of the range
-    double pix = (scale - scaleStart)/getTotalRange();
-
-    // Map to pixel range
     if(horizontal)
-        pix *= (size.width());
+        return scaleToPixelT<true>(scale);
     else
-    {
-        pix *= (size.height());
+        return scaleToPixelT<false>(scale);
 
-        // Vertical pixels are reversed
-        pix = size.height() - pix;
-    }
+}// scaleToPixel
 
-    return pix;
 
-}// scaleToPixel
+/*!
+ * Convert a range in the users units to the range in pixels along the scale
+ * \param range is the range in users units
+ * \return the length of the range in pixels
+ */
+double LinearGaugeScene::scaleRangeToPixelRange(double range)
+{
+    if(getTotalRange() <= 0.0)
+        return 0.0;
+
+    if(horizontal)
+        return range*size.width()/getTotalRange();
+    else
+        return range*size.height()/getTotalRange();
+
+}// LinearGaugeScene::scaleRangeToPixelRange
 
 
 /*!
@@ -740,7 +756,17 @@ void LinearGaugeScene::createScene(QGraphicsScene& scene)
 
     // Does not exist now
     rectItem = 0;
-    readingTextItem = 0;
+    fillItem = 0;
+    fillItem2 = 0;
+
+    // The per reading functions for this orientation
+    selectOrientation();
+
+    // Where the reading goes, the text item is created with the first reading
+    layoutReadingLabel();
+
+    // The rects that show the readings, these are kept for every reading
+    buildRect(scene);
 
     // Now the tick marks
     buildMinorTicks(scene);
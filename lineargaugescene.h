@@ -2,11 +2,16 @@
 #define LINEARGAUGESCENE_H
 
 #include "gauge.h"
+#include "lineargaugeaxis.h"
 #include <QGraphicsView>
 #include <QGraphicsScene>
 #include <QColor>
 #include <QRect>
 #include <QPainterPath>
+#include <QHash>
+#include <QPointF>
+#include <QRectF>
+#include <QString>
 
 /*!
  * \brief The LinearGaugeScene class uses QGraphicsScene to display an vertical or horizontal gauge.
@@ -57,7 +62,7 @@ public:
     void setTicksBothSides(bool bothSides);
 
     //! Set if the gauge displays two values or just one (the default)
-    void setDualValue(bool dual) {dualvalue = dual;}
+    void setDualValue(bool dual);
 
     //! Set if the gauge displays two text labels or just one (the default)
     void setDualValueLabel(bool dual) {dualvaluelabel = dual;}
@@ -85,15 +90,33 @@ protected: // methods
     virtual void updateReading(QGraphicsScene& scene);
 
     void buildRect(QGraphicsScene& scene);
+    template<bool horizontal, bool dual> void updateRectT(void);
+    void selectOrientation(void);
     void buildMajorTicks(QGraphicsScene& scene);
     void buildMinorTicks(QGraphicsScene& scene);
     void buildLabels(QGraphicsScene& scene);
+    void layoutReadingLabel(void);
     void buildReadingLabel(QGraphicsScene& scene);
-    void buildHorizontalTicks(QPainterPath& path, double tickLength, double spacing);
-    void buildVerticalTicks(QPainterPath& path, double tickLength, double spacing);
+    template<bool horizontal> void buildTicks(QPainterPath& path, double tickLength, double spacing);
     double scaleToPixel(double scale);
+
+    //! Convert a reading to the pixel location along the scale, for one orientation
+    template<bool horizontal> double scaleToPixelT(double scale) const
+    {
+        // Make sure in bounds
+        if(scale < scaleStart)
+            scale = scaleStart;
+        else if(scale > scaleStart + getTotalRange())
+            scale = scaleStart + getTotalRange();
+
+        // The fraction of the range, mapped to pixels
+        return linearAxis<horizontal>::toPixel((scale - scaleStart)/getTotalRange(), size);
+    }
     double scaleRangeToPixelRange(double scale);
 
+    //! \return the range the number of tick marks is limited over
+    virtual double tickRange(void) const {return getTotalRange();}
+
 protected:    // properties
 
     double textReading2;            //!< The second gauge reading for the text
@@ -105,8 +128,18 @@ protected:    // properties
     bool ticksRightOrBottom;        //!< Flag to put the tick marks on the right or bottom side
     bool ticksBothSides;            //!< Flag to put the tick marks on both sides
     QRect size;                     //!< The size of the viewing rect
-    QGraphicsRectItem* rectItem;    //!< The primary display of the first value
+    QGraphicsRectItem* rectItem;    //!< The border around the display of the values
+    QGraphicsRectItem* fillItem;    //!< The primary display of the first value
+    QGraphicsRectItem* fillItem2;   //!< The display of the second value
+    QColor borderColor;             //!< Color of the border now, so it is only set when it changes
+    QColor fillColor;               //!< Color of the first value now, so it is only set when it changes
+    QColor fillColor2;              //!< Color of the second value now, so it is only set when it changes
     QGraphicsTextItem* readingTextItem; //!< The text display of the values
+    QString readingText;            //!< The text displayed now, so the item is only changed when the text changes
+    QPointF readingAnchor;          //!< Location of the reading text, computed when the scene is created
+    Qt::Alignment readingAlignment; //!< How the reading text is placed with respect to the anchor
+    QHash<QString, QRectF> readingRects;//!< Size of the reading text for each pattern of characters, with the digits as '0'
+    void (LinearGaugeScene::*rectUpdater)(void);    //!< updateRectT() for the orientation and dual values
 };
 
 #endif // LINEARGAUGESCENE_H
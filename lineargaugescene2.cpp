@@ -6,6 +6,8 @@ LinearGaugeScene2::LinearGaugeScene2() :
     LinearGaugeScene(),
     pathItem(0),
     path2Item(0),
+    thumbDual(false),
+    thumbMover(&LinearGaugeScene2::moveThumbT<false>),
     thumbWidth(0.05),
     barWidth(0.25),
     thumbColor(Qt::white)
@@ -19,7 +21,7 @@ LinearGaugeScene2::LinearGaugeScene2() :
  */
 void LinearGaugeScene2::updateReading(QGraphicsScene& scene)
 {
-    buildThumb(scene);
+    moveThumb(scene);
 }
 
 
@@ -84,25 +86,17 @@ void LinearGaugeScene2::buildRects(QGraphicsScene& scene)
 
 
 /*!
- * Draw the gauge reading, assume all other drawing is done and good
- * \param scene will be updated with the new reading
+ * Build the thumbs, centered on the start of the scale axis.  The shape of a
+ * thumb only depends on the geometry, so this is done when the scene is
+ * created, and moveThumb() positions the thumbs for each reading.
+ * \param scene receives the thumbs.  The caller must make sure that the
+ *        previous thumbs have been removed from the scene.
  */
 void LinearGaugeScene2::buildThumb(QGraphicsScene& scene)
 {
-    // Remove the old rect
-    if(pathItem)
-    {
-        scene.removeItem(pathItem);
-        delete pathItem;
-        pathItem = 0;
-    }
-
-    if(path2Item)
-    {
-        scene.removeItem(path2Item);
-        delete path2Item;
-        path2Item = 0;
-    }
+    pathItem = 0;
+    path2Item = 0;
+    thumbDual = dualvalue;
 
     if(thumbWidth <= 0.0)
         return;
@@ -113,127 +107,97 @@ void LinearGaugeScene2::buildThumb(QGraphicsScene& scene)
     QPainterPath path;
 
     // The first reading
-    drawThumb(path, scaleToPixel(gaugeReading), ticksRightOrBottom);
+    if(horizontal)
+        drawThumbT<true>(path, 0.0, ticksRightOrBottom);
+    else
+        drawThumbT<false>(path, 0.0, ticksRightOrBottom);
     pathItem = scene.addPath(path, pen, brush);
 
     if(dualvalue)
     {
         path = QPainterPath();
-        drawThumb(path, scaleToPixel(gaugeReading2), !ticksRightOrBottom);
+        if(horizontal)
+            drawThumbT<true>(path, 0.0, !ticksRightOrBottom);
+        else
+            drawThumbT<false>(path, 0.0, !ticksRightOrBottom);
         path2Item = scene.addPath(path, pen, brush);
     }
 
 }// LinearGaugeScene2::buildThumb
 
 
-void LinearGaugeScene2::drawThumb(QPainterPath& path, double location, bool rightorbottom)
+/*!
+ * Move the thumbs to the readings.  This is only a change of position, unless
+ * dual values were turned on or off, which changes the shape of the thumbs.
+ * \param scene holds the thumbs
+ */
+void LinearGaugeScene2::moveThumb(QGraphicsScene& scene)
 {
-    if(horizontal)
+    // The shape of the thumb depends on dual values
+    if(thumbDual != dualvalue)
     {
-        double width = size.width()*thumbWidth;
-        double left = location - width*0.5;
-
-        // If we are drawing tick marks then I want the thumb to be a pointer at the tick marks
-        if(rightorbottom)
-        {
-            if(dualvalue)
-            {
-                // Thumb on the top, pointing down
-                path.moveTo(left, 0.5*size.height());
-                path.lineTo(left+width, 0.5*size.height());
-                path.lineTo(location, size.height());
-                path.lineTo(left, 0.5*size.height());
-            }
-            else
-            {
-                // Thumb on the top, pointing down
-                path.moveTo(left, 0);
-                path.lineTo(left+width, 0);
-                path.lineTo(left+width, 0.5*size.height());
-                path.lineTo(location, size.height());
-                path.lineTo(left, 0.5*size.height());
-                path.lineTo(left, 0);
-            }
-
-        }// if ticks on the bottom
-        else
-        {
-            if(dualvalue)
-            {
-                // Thumb on the bottom, pointing up
-                path.moveTo(left, 0.5*size.height());
-                path.lineTo(left+width, 0.5*size.height());
-                path.lineTo(location, 0);
-                path.lineTo(left, 0.5*size.height());
-            }
-            else
-            {
-                // Thumb on the bottom, pointing up
-                path.moveTo(left, size.height());
-                path.lineTo(left+width, size.height());
-                path.lineTo(left+width, 0.5*size.height());
-                path.lineTo(location, 0);
-                path.lineTo(left, 0.5*size.height());
-                path.lineTo(left, size.height());
-            }
-
-        }// if ticks on the top
-
-    }// if horizontal gauge
+        delete pathItem;
+        delete path2Item;
+        buildThumb(scene);
+    }
+
+    (this->*thumbMover)();
+
+}// LinearGaugeScene2::moveThumb
+
+
+/*!
+ * Draw the outline of a thumb.  The thumb is a pointer at the tick marks, on
+ * one side of the gauge, or on its half of the gauge for dual values.
+ * \param path receives the outline of the thumb
+ * \param location is the location of the point of the thumb along the scale
+ * \param rightorbottom should be true to point at the right or bottom side
+ */
+template<bool horizontal> void LinearGaugeScene2::drawThumbT(QPainterPath& path, double location, bool rightorbottom)
+{
+    typedef linearAxis<horizontal> axis;
+
+    double width = axis::length(size)*thumbWidth;
+    double start = location - width*0.5;
+    double breadth = axis::breadth(size);
+
+    // The thumb is drawn pointing at the far side, and mirrored for the near side
+    double base = rightorbottom ? 0.0 : breadth;
+    double middle = 0.5*breadth;
+    double tip = rightorbottom ? breadth : 0.0;
+
+    if(dualvalue)
+    {
+        // Only the half of the gauge for this reading
+        path.moveTo(axis::point(start, middle));
+        path.lineTo(axis::point(start+width, middle));
+        path.lineTo(axis::point(location, tip));
+        path.lineTo(axis::point(start, middle));
+    }
     else
     {
-        double height = size.height()*thumbWidth;
-        double top = location - height*0.5;
-
-        // If we are drawing tick marks then I want the thumb to be a pointer at the tick marks
-        if(rightorbottom)
-        {
-            if(dualvalue)
-            {
-                // Thumb on the left, pointing right
-                path.moveTo(0.5*size.width(), top);
-                path.lineTo(size.width(), location);
-                path.lineTo(0.5*size.width(), top+height);
-                path.lineTo(0.5*size.width(), top);
-            }
-            else
-            {
-                // Thumb on the left, pointing right
-                path.moveTo(0, top);
-                path.lineTo(0.5*size.width(), top);
-                path.lineTo(size.width(), location);
-                path.lineTo(0.5*size.width(), top+height);
-                path.lineTo(0, top+height);
-                path.lineTo(0, top);
-            }
-
-        }// if ticks on the right
-        else
-        {
-            if(dualvalue)
-            {
-                // Thumb on the right, pointing left
-                path.moveTo(0.5*size.width(), top);
-                path.lineTo(0, location);
-                path.lineTo(0.5*size.width(), top+height);
-                path.lineTo(0.5*size.width(), top);
-            }
-            else
-            {
-                // Thumb on the right, pointing left
-                path.moveTo(size.width(), top);
-                path.lineTo(0.5*size.width(), top);
-                path.lineTo(0, location);
-                path.lineTo(0.5*size.width(), top+height);
-                path.lineTo(size.width(), top+height);
-                path.lineTo(size.width(), top);
-            }
-
-        }// if ticks on the left
-
-    }// if vertical gauge
-
-}// LinearGaugeScene2::drawThumb
+        path.moveTo(axis::point(start, base));
+        path.lineTo(axis::point(start+width, base));
+        path.lineTo(axis::point(start+width, middle));
+        path.lineTo(axis::point(location, tip));
+        path.lineTo(axis::point(start, middle));
+        path.lineTo(axis::point(start, base));
+    }
+
+}// LinearGaugeScene2::drawThumbT
+
+
+/*!
+ * Move the thumbs to the readings along the scale
+ */
+template<bool horizontal> void LinearGaugeScene2::moveThumbT(void)
+{
+    if(pathItem)
+        pathItem->setPos(linearAxis<horizontal>::point(scaleToPixelT<horizontal>(gaugeReading), 0));
+
+    if(path2Item)
+        path2Item->setPos(linearAxis<horizontal>::point(scaleToPixelT<horizontal>(gaugeReading2), 0));
+}
 
 
 /*!
@@ -253,6 +217,8 @@ void LinearGaugeScene2::createScene(QGraphicsScene& scene)
 
     // Does not exist now
     rectItem = 0;
+    fillItem = 0;
+    fillItem2 = 0;
     readingTextItem = 0;
     pathItem = 0;
     path2Item = 0;
@@ -270,8 +236,10 @@ void LinearGaugeScene2::createScene(QGraphicsScene& scene)
     // No longer dirty
     dirty = false;
 
-    // The variable stuff
+    // The thumbs are built once, and moved for each reading
+    thumbMover = horizontal ? &LinearGaugeScene2::moveThumbT<true> : &LinearGaugeScene2::moveThumbT<false>;
     buildThumb(scene);
+    moveThumb(scene);
 
 }// LinearGaugeScene::createScene
 
@@ -33,11 +33,15 @@ protected: // methods
 
     void buildRects(QGraphicsScene& scene);
     void buildThumb(QGraphicsScene& scene);
-    void drawThumb(QPainterPath& path, double location, bool rightorbottom);
+    void moveThumb(QGraphicsScene& scene);
+    template<bool horizontal> void drawThumbT(QPainterPath& path, double location, bool rightorbottom);
+    template<bool horizontal> void moveThumbT(void);
 
 protected: // properties
-    QGraphicsPathItem* pathItem;
-    QGraphicsPathItem* path2Item;
+    QGraphicsPathItem* pathItem;    //!< Thumb of the first reading, positioned along the scale
+    QGraphicsPathItem* path2Item;   //!< Thumb of the second reading, positioned along the scale
+    bool thumbDual;                 //!< True if the thumbs were built for dual values
+    void (LinearGaugeScene2::*thumbMover)(void);    //!< moveThumbT() for the orientation
 
     double thumbWidth;  //!< Size of the thumb as a fraction of the scene
     double barWidth;    //!< Width of the bar as a fraction of the scene
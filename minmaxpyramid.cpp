@@ -0,0 +1,182 @@
+#include "minmaxpyramid.h"
+
+MinMaxPyramid::MinMaxPyramid() :
+    count(0),
+    builtScaler(1.0),
+    increasing(false)
+{
+}
+
+
+/*!
+ * Build all levels of the pyramid. This only touches the pyramid itself, so it
+ * can be run on a worker thread as long as the data is not changing.
+ * \param data is the array to describe
+ * \param scaler multiplies every value of data before it is used
+ */
+void MinMaxPyramid::build(const std::vector<double> & data, double scaler)
+{
+    clear();
+
+    count = data.size();
+    builtScaler = scaler;
+    if(count < 2)
+        return;
+
+    increasing = true;
+
+    // The finest level comes from pairs of samples
+    std::vector<double> mins((count + 1)/2), maxs((count + 1)/2);
+    for(size_t i = 0; i < count/2; i++)
+    {
+        double first = data[2*i]*scaler;
+        double second = data[2*i + 1]*scaler;
+
+        if(first <= second)
+        {
+            mins[i] = first;
+            maxs[i] = second;
+        }
+        else
+        {
+            mins[i] = second;
+            maxs[i] = first;
+            increasing = false;
+        }
+
+        // The pairs themselves must also be in order
+        if((i > 0) && (first < data[2*i - 1]*scaler))
+            increasing = false;
+    }
+
+    // A left over sample is a block by itself
+    if(count & 1)
+    {
+        mins.back() = maxs.back() = data[count - 1]*scaler;
+        if(mins.back() < data[count - 2]*scaler)
+            increasing = false;
+    }
+
+    minimums.push_back(mins);
+    maximums.push_back(maxs);
+
+    // Each coarser level combines pairs of blocks from the level below
+    while(minimums.back().size() > 1)
+    {
+        const std::vector<double> & lowMins = minimums.back();
+        const std::vector<double> & lowMaxs = maximums.back();
+        size_t lowBlocks = lowMins.size();
+
+        mins.assign((lowBlocks + 1)/2, 0.0);
+        maxs.assign((lowBlocks + 1)/2, 0.0);
+        for(size_t i = 0; i < lowBlocks/2; i++)
+        {
+            mins[i] = (lowMins[2*i] < lowMins[2*i + 1]) ? lowMins[2*i] : lowMins[2*i + 1];
+            maxs[i] = (lowMaxs[2*i] > lowMaxs[2*i + 1]) ? lowMaxs[2*i] : lowMaxs[2*i + 1];
+        }
+
+        if(lowBlocks & 1)
+        {
+            mins.back() = lowMins.back();
+            maxs.back() = lowMaxs.back();
+        }
+
+        minimums.push_back(mins);
+        maximums.push_back(maxs);
+
+    }// while more than one block in the top level
+
+}// MinMaxPyramid::build
+
+
+/*!
+ * Remove all levels of the pyramid
+ */
+void MinMaxPyramid::clear(void)
+{
+    minimums.clear();
+    maximums.clear();
+    count = 0;
+    builtScaler = 1.0;
+    increasing = false;
+}
+
+
+/*!
+ * Find the coarsest level whose blocks are no larger than a number of samples.
+ * Drawing from this level keeps at least one block per pixel if samplesPerBlock
+ * is the number of samples per pixel.
+ * \param samplesPerBlock is the largest number of samples a block can cover
+ * \param level receives the level
+ * \return true if a level was found, false if even the finest level is too coarse
+ */
+bool MinMaxPyramid::levelForSamples(double samplesPerBlock, size_t* level) const
+{
+    if(isEmpty() || (samplesPerBlock < blockSize(0)))
+        return false;
+
+    size_t i = 0;
+    while((i + 1 < levels()) && (blockSize(i + 1) <= samplesPerBlock))
+        i++;
+
+    *level = i;
+    return true;
+
+}// MinMaxPyramid::levelForSamples
+
+
+/*!
+ * Find the range of a slice of the data using the largest blocks that fit
+ * inside the slice, so the cost is logarithmic in the length of the slice.
+ * \param data is the array the pyramid was built from, used for the samples
+ *        at the ends of the slice that do not fill a block
+ * \param scaler is the scaler the pyramid was built with
+ * \param first is the index of the first sample of the slice
+ * \param last is the index of the last sample of the slice, which must be
+ *        at least first and less than samples()
+ * \param minValue receives the smallest scaled value in the slice
+ * \param maxValue receives the largest scaled value in the slice
+ */
+void MinMaxPyramid::range(const std::vector<double> & data, double scaler, size_t first, size_t last, double* minValue, double* maxValue) const
+{
+    *minValue = *maxValue = data[first]*scaler;
+
+    size_t i = first;
+    while(i <= last)
+    {
+        // The largest block that starts at i and ends inside the slice
+        size_t level = 0;
+        bool found = false;
+        while((level < levels()) && ((i % blockSize(level)) == 0) && (i + blockSize(level) - 1 <= last))
+        {
+            found = true;
+            level++;
+        }
+
+        if(found)
+        {
+            level--;
+            size_t block = i/blockSize(level);
+
+            if(minimums[level][block] < *minValue)
+                *minValue = minimums[level][block];
+            if(maximums[level][block] > *maxValue)
+                *maxValue = maximums[level][block];
+
+            i += blockSize(level);
+        }
+        else
+        {
+            double value = data[i]*scaler;
+
+            if(value < *minValue)
+                *minValue = value;
+            if(value > *maxValue)
+                *maxValue = value;
+
+            i++;
+        }
+
+    }// while more of the slice to cover
+
+}// MinMaxPyramid::range
@@ -0,0 +1,69 @@
+#ifndef MINMAXPYRAMID_H
+#define MINMAXPYRAMID_H
+
+#include <stddef.h>
+#include <vector>
+
+/*!
+ * \brief The MinMaxPyramid class holds the minimum and maximum of a data array
+ * over blocks of power-of-two size.
+ *
+ * Level 0 describes blocks of 2 samples, level 1 blocks of 4 samples, and so
+ * on until a single block covers the whole array. The last block of a level
+ * may be short if the data length is not a power of two. When a plot would
+ * draw many samples per pixel it can draw the block minimum and maximum of a
+ * coarser level instead, which looks the same but costs far less.
+ */
+class MinMaxPyramid
+{
+public:
+    MinMaxPyramid();
+
+    //! Build the pyramid from scaled data
+    void build(const std::vector<double> & data, double scaler);
+
+    //! Remove all levels of the pyramid
+    void clear(void);
+
+    //! \return true if the pyramid has not been built
+    bool isEmpty(void) const {return minimums.empty();}
+
+    //! \return the number of samples the pyramid was built from
+    size_t samples(void) const {return count;}
+
+    //! \return the scaler the pyramid was built with
+    double scaler(void) const {return builtScaler;}
+
+    //! \return the number of levels in the pyramid
+    size_t levels(void) const {return minimums.size();}
+
+    //! \return the number of samples in each block of a level
+    static size_t blockSize(size_t level) {return ((size_t)2) << level;}
+
+    //! \return the number of blocks in a level
+    size_t blocks(size_t level) const {return minimums[level].size();}
+
+    //! \return the minimum value of a block in a level
+    double minimum(size_t level, size_t block) const {return minimums[level][block];}
+
+    //! \return the maximum value of a block in a level
+    double maximum(size_t level, size_t block) const {return maximums[level][block];}
+
+    //! \return true if the data the pyramid was built from never decreases
+    bool isIncreasing(void) const {return increasing;}
+
+    //! Find the coarsest level whose blocks do not exceed a number of samples
+    bool levelForSamples(double samplesPerBlock, size_t* level) const;
+
+    //! Find the range of a slice of the data the pyramid was built from
+    void range(const std::vector<double> & data, double scaler, size_t first, size_t last, double* minValue, double* maxValue) const;
+
+private:
+    std::vector< std::vector<double> > minimums;    //!< Block minimums for each level
+    std::vector< std::vector<double> > maximums;    //!< Block maximums for each level
+    size_t count;                                   //!< Number of samples the pyramid was built from
+    double builtScaler;                             //!< Scaler the pyramid was built with
+    bool increasing;                                //!< True if the samples never decrease
+};
+
+#endif // MINMAXPYRAMID_H
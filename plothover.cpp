@@ -0,0 +1,340 @@
+#include "plothover.h"
+#include <QGraphicsSceneHoverEvent>
+#include <QPainterPath>
+#include <QPen>
+#include <math.h>
+
+//! Width and height in pixels of the cells of the spatial grid
+static const double hoverCellSize = 8.0;
+
+/*!
+ * Build the index for a plot.  When the x data are not increasing every
+ * sample of every channel in the grid is sorted into its cell, which is
+ * O(n).  This only reads the data, so it can be run on a worker thread.
+ * \param snapshot is the data of the plot
+ * \param yMapping is the mapping from the y data to the scene
+ * \param rMapping is the mapping from the r data to the scene
+ * \param slice is the range of samples that are drawn
+ * \param plotGrid is the region of the scene covered by the grid of the plot
+ */
+plotHoverIndex::plotHoverIndex(std::shared_ptr<const plotSnapshot> snapshot, const plotMapping & yMapping, const plotMapping & rMapping, const plotSlice & slice, const QRectF & plotGrid) :
+    data(snapshot),
+    yMap(yMapping),
+    rMap(rMapping),
+    first(slice.first),
+    last(slice.last),
+    increasing(slice.increasing),
+    grid(plotGrid.normalized()),
+    cellSize(hoverCellSize),
+    columns(0),
+    rows(0)
+{
+    if(last >= data->x.data.size())
+        last = data->x.data.size() - 1;
+
+    if(increasing || data->x.data.empty() || grid.isEmpty())
+        return;
+
+    columns = (size_t)ceil(grid.width()/cellSize) + 1;
+    rows = (size_t)ceil(grid.height()/cellSize) + 1;
+
+    // Counting sort of every sample into its cell, first count the samples of each cell
+    std::vector<size_t> cells;
+    std::vector<hoverEntry> entries;
+    for(size_t c = 0; c < channels(); c++)
+    {
+        for(size_t i = first; (i <= last) && hasSample(c, i); i++)
+        {
+            QPointF pos = point(c, i);
+            double x = (pos.x() - grid.left())/cellSize;
+            double y = (pos.y() - grid.top())/cellSize;
+
+            // This also rejects NaN
+            if(!((x >= 0.0) && (x < columns) && (y >= 0.0) && (y < rows)))
+                continue;
+
+            hoverEntry entry = {(uint32_t)c, i};
+            cells.push_back(((size_t)y)*columns + (size_t)x);
+            entries.push_back(entry);
+        }
+    }
+
+    cellStart.assign(columns*rows + 1, 0);
+    for(size_t k = 0; k < cells.size(); k++)
+        cellStart[cells[k] + 1]++;
+
+    for(size_t k = 1; k < cellStart.size(); k++)
+        cellStart[k] += cellStart[k-1];
+
+    // Then put each entry in its place
+    std::vector<size_t> next(cellStart.begin(), cellStart.end() - 1);
+    cellEntries.resize(entries.size());
+    for(size_t k = 0; k < entries.size(); k++)
+        cellEntries[next[cells[k]]++] = entries[k];
+
+}// plotHoverIndex::plotHoverIndex
+
+
+/*!
+ * Get the data of a channel
+ * \param index is the index of the channel, y channels then r channels
+ * \return the data of the channel
+ */
+const plotData* plotHoverIndex::channel(size_t index) const
+{
+    if(index < data->ySet.size())
+        return data->ySet[index];
+    else
+        return data->rSet[index - data->ySet.size()];
+}
+
+
+/*!
+ * Determine if a channel has a sample, the data of a channel may be shorter
+ * than the x data.
+ * \param index is the index of the channel, y channels then r channels
+ * \param sample is the index of the sample
+ * \return true if the channel and the x data both have the sample
+ */
+bool plotHoverIndex::hasSample(size_t index, size_t sample) const
+{
+    return (sample < data->x.data.size()) && (sample < channel(index)->data.size());
+}
+
+
+/*!
+ * Get the scene location of a sample of a channel
+ * \param index is the index of the channel, y channels then r channels
+ * \param sample is the index of the sample, which hasSample() must accept
+ * \return the scene location of the sample
+ */
+QPointF plotHoverIndex::point(size_t index, size_t sample) const
+{
+    const plotData* y = channel(index);
+    const plotMapping & map = mapping(index);
+
+    return QPointF(map.toX(data->x.data[sample]*data->x.scaler), map.toY(y->data[sample]*y->scaler));
+}
+
+
+/*!
+ * Find the sample nearest a point in the scene.  For increasing x data this is
+ * the sample with the nearest x, found by binary search.  Otherwise it is the
+ * sample of any channel nearest the point, found by searching rings of cells
+ * outward from the point until no closer sample is possible.
+ * \param pos is the point in the scene
+ * \param sample receives the index of the nearest sample
+ * \return true if a sample was found
+ */
+bool plotHoverIndex::nearest(QPointF pos, size_t* sample) const
+{
+    if(data->x.data.empty() || (first > last))
+        return false;
+
+    if(increasing)
+    {
+        const array & x = data->x.data;
+        double scaler = data->x.scaler;
+        double value = yMap.xMin + (pos.x() - yMap.xOrg)/yMap.xScale;
+
+        // Binary search for the first sample at or past the value
+        size_t low = first;
+        size_t high = last + 1;
+        while(low < high)
+        {
+            size_t mid = low + (high - low)/2;
+            if(x[mid]*scaler < value)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+
+        // The nearest is this sample, or the one before it
+        if(low > last)
+            low = last;
+        else if((low > first) && (value - x[low-1]*scaler < x[low]*scaler - value))
+            low--;
+
+        *sample = low;
+        return true;
+
+    }// if x is increasing
+
+    if(cellEntries.empty())
+        return false;
+
+    // Start from the cell under the point, clamped to the grid
+    double fx = (pos.x() - grid.left())/cellSize;
+    double fy = (pos.y() - grid.top())/cellSize;
+    long column = (long)floor(fx);
+    long row = (long)floor(fy);
+    if(column < 0)
+        column = 0;
+    else if(column >= (long)columns)
+        column = (long)columns - 1;
+    if(row < 0)
+        row = 0;
+    else if(row >= (long)rows)
+        row = (long)rows - 1;
+
+    bool found = false;
+    double best = 0.0;
+    long rings = (long)((columns > rows) ? columns : rows);
+
+    for(long ring = 0; ring <= rings; ring++)
+    {
+        // Anything in this ring or beyond is at least this far away
+        if(found)
+        {
+            double reach = (ring - 1)*cellSize;
+            if((reach > 0.0) && (reach*reach > best))
+                break;
+        }
+
+        for(long r = row - ring; r <= row + ring; r++)
+        {
+            if((r < 0) || (r >= (long)rows))
+                continue;
+
+            // Only the border of the ring, the inside was already searched
+            long step = ((r == row - ring) || (r == row + ring)) ? 1 : 2*ring;
+            if(step == 0)
+                step = 1;
+
+            for(long c = column - ring; c <= column + ring; c += step)
+            {
+                if((c < 0) || (c >= (long)columns))
+                    continue;
+
+                size_t cell = ((size_t)r)*columns + (size_t)c;
+                for(size_t k = cellStart[cell]; k < cellStart[cell+1]; k++)
+                {
+                    QPointF delta = point(cellEntries[k].channel, cellEntries[k].sample) - pos;
+                    double distance = delta.x()*delta.x() + delta.y()*delta.y();
+                    if(!found || (distance < best))
+                    {
+                        found = true;
+                        best = distance;
+                        *sample = cellEntries[k].sample;
+                    }
+                }
+
+            }// for all columns of the ring
+
+        }// for all rows of the ring
+
+    }// for all rings
+
+    return found;
+
+}// plotHoverIndex::nearest
+
+
+/*!
+ * Create the hover item for a plot.  It covers the grid of the plot, and is
+ * invisible until the mouse is over it.
+ * \param hoverIndex finds the sample under the mouse
+ * \param parent is the parent item, which can be null
+ */
+PlotHoverItem::PlotHoverItem(std::shared_ptr<const plotHoverIndex> hoverIndex, QGraphicsItem* parent) :
+    QGraphicsRectItem(hoverIndex->getGrid(), parent),
+    index(hoverIndex)
+{
+    setPen(Qt::NoPen);
+    setAcceptHoverEvents(true);
+    setAcceptedMouseButtons(Qt::NoButton);
+
+    crosshair = new QGraphicsPathItem(this);
+    crosshair->setPen(QPen(Qt::darkGray));
+    crosshair->setVisible(false);
+
+    readout = new QGraphicsTextItem(this);
+    readout->setVisible(false);
+
+}// PlotHoverItem::PlotHoverItem
+
+
+//! Show the sample under the mouse when it enters the grid
+void PlotHoverItem::hoverEnterEvent(QGraphicsSceneHoverEvent* event)
+{
+    showNearest(event->pos());
+}
+
+
+//! Show the sample under the mouse as it moves over the grid
+void PlotHoverItem::hoverMoveEvent(QGraphicsSceneHoverEvent* event)
+{
+    showNearest(event->pos());
+}
+
+
+//! Hide the crosshair and readout when the mouse leaves the grid
+void PlotHoverItem::hoverLeaveEvent(QGraphicsSceneHoverEvent* event)
+{
+    Q_UNUSED(event);
+
+    crosshair->setVisible(false);
+    readout->setVisible(false);
+}
+
+
+/*!
+ * Move the crosshair to the sample nearest a point, and show the values of
+ * every channel at that sample.
+ * \param pos is the point, in item coordinates
+ */
+void PlotHoverItem::showNearest(QPointF pos)
+{
+    size_t sample;
+    if((index->channels() == 0) || !index->nearest(pos, &sample))
+    {
+        crosshair->setVisible(false);
+        readout->setVisible(false);
+        return;
+    }
+
+    QRectF grid = rect();
+    const plotData* x = index->xData();
+    QString text = QString("%1: %2").arg(x->title).arg(x->data[sample]*x->scaler, 0, 'g', 6);
+
+    // A vertical line through the sample, and a circle on each channel
+    QPainterPath path;
+    bool line = false;
+    for(size_t c = 0; c < index->channels(); c++)
+    {
+        if(!index->hasSample(c, sample))
+            continue;
+
+        const plotData* y = index->channel(c);
+        QPointF point = index->point(c, sample);
+
+        if(!line)
+        {
+            path.moveTo(point.x(), grid.top());
+            path.lineTo(point.x(), grid.bottom());
+            line = true;
+        }
+
+        if(grid.contains(point))
+            path.addEllipse(point, 3.0, 3.0);
+
+        text += QString("\n%1: %2").arg(y->title).arg(y->data[sample]*y->scaler, 0, 'g', 6);
+    }
+
+    crosshair->setPath(path);
+    crosshair->setVisible(true);
+
+    readout->setPlainText(text);
+
+    // Keep the readout next to the mouse, but inside the grid
+    QRectF box = readout->boundingRect();
+    QPointF corner = pos + QPointF(10.0, 10.0);
+    if(corner.x() + box.width() > grid.right())
+        corner.setX(pos.x() - 10.0 - box.width());
+    if(corner.y() + box.height() > grid.bottom())
+        corner.setY(pos.y() - 10.0 - box.height());
+
+    readout->setPos(corner);
+    readout->setVisible(true);
+
+}// PlotHoverItem::showNearest
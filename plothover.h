@@ -0,0 +1,105 @@
+#ifndef PLOTHOVER_H
+#define PLOTHOVER_H
+
+#include "twodimensionalplot.h"
+#include <QGraphicsRectItem>
+#include <QGraphicsPathItem>
+#include <QGraphicsTextItem>
+#include <memory>
+#include <stdint.h>
+
+//! One sample of one channel in the spatial grid of a plotHoverIndex
+class hoverEntry
+{
+public:
+    uint32_t channel;   //!< Index of the channel, y channels then r channels
+    size_t sample;      //!< Index of the sample
+};
+
+
+/*!
+ * \brief The plotHoverIndex class finds the sample nearest a point on a plot.
+ *
+ * When the x data are increasing the nearest x is found with a binary search,
+ * which is O(log n). Otherwise the samples of every channel are sorted into a
+ * grid of small cells once, and only the cells near the point are searched.
+ * The index keeps its own copy of the data, so it can outlive the caller's.
+ */
+class plotHoverIndex
+{
+public:
+    //! Build the index for a plot, safe to call from a worker thread
+    plotHoverIndex(std::shared_ptr<const plotSnapshot> snapshot, const plotMapping & yMapping, const plotMapping & rMapping, const plotSlice & slice, const QRectF & grid);
+
+    //! Find the sample nearest a point in the scene
+    bool nearest(QPointF pos, size_t* sample) const;
+
+    //! \return the number of channels, y channels then r channels
+    size_t channels(void) const {return data->ySet.size() + data->rSet.size();}
+
+    //! \return the data of a channel
+    const plotData* channel(size_t index) const;
+
+    //! \return the x data
+    const plotData* xData(void) const {return &data->x;}
+
+    //! \return true if a channel has a sample at an index
+    bool hasSample(size_t index, size_t sample) const;
+
+    //! \return the scene location of a sample of a channel
+    QPointF point(size_t index, size_t sample) const;
+
+    //! \return the region of the scene covered by the grid of the plot
+    QRectF getGrid(void) const {return grid;}
+
+protected:
+    const plotMapping & mapping(size_t index) const {return (index < data->ySet.size()) ? yMap : rMap;}
+
+    std::shared_ptr<const plotSnapshot> data;   //!< The data of the plot
+    plotMapping yMap;                   //!< Mapping from y data to the scene
+    plotMapping rMap;                   //!< Mapping from r data to the scene
+    size_t first;                       //!< Index of the first sample drawn
+    size_t last;                        //!< Index of the last sample drawn
+    bool increasing;                    //!< True if the x data never decreases
+    QRectF grid;                        //!< Region of the scene covered by the grid
+    double cellSize;                    //!< Width and height of each cell in pixels
+    size_t columns;                     //!< Number of cells across the grid
+    size_t rows;                        //!< Number of cells down the grid
+    std::vector<size_t> cellStart;      //!< Index in cellEntries of the first entry of each cell, plus one past the end
+    std::vector<hoverEntry> cellEntries;//!< Entries of every cell, sorted by cell
+};
+
+
+/*!
+ * \brief The PlotHoverItem class shows a crosshair and the values of every
+ * channel at the sample under the mouse.
+ *
+ * The item covers the grid of a plot and accepts hover events. Each mouse move
+ * is one query of the index, and only updates the crosshair and the readout,
+ * which are children of this item. The plot itself is never regenerated.
+ */
+class PlotHoverItem : public QGraphicsRectItem
+{
+public:
+    //! Create the hover item for a plot
+    PlotHoverItem(std::shared_ptr<const plotHoverIndex> index, QGraphicsItem* parent = 0);
+
+protected:
+    //! Show the sample under the mouse
+    virtual void hoverEnterEvent(QGraphicsSceneHoverEvent* event) override;
+
+    //! Show the sample under the mouse
+    virtual void hoverMoveEvent(QGraphicsSceneHoverEvent* event) override;
+
+    //! Hide the crosshair and readout
+    virtual void hoverLeaveEvent(QGraphicsSceneHoverEvent* event) override;
+
+    //! Move the crosshair and readout to the sample nearest a point
+    void showNearest(QPointF pos);
+
+    std::shared_ptr<const plotHoverIndex> index;    //!< Finds the sample under the mouse
+    QGraphicsPathItem* crosshair;   //!< Line through the sample, and a circle on each channel
+    QGraphicsTextItem* readout;     //!< Values of every channel at the sample
+};
+
+#endif // PLOTHOVER_H
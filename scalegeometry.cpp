@@ -0,0 +1,128 @@
+#include "scalegeometry.h"
+#include <math.h>
+
+//! Number of rotation steps between exact computations of the direction
+#define SCALE_GEOMETRY_RESYNC 32
+
+ScaleGeometry::ScaleGeometry()
+{
+}
+
+
+/*!
+ * Count the values from start to end inclusive, in increments of step. The
+ * count is made by adding step, just like the loops that label the scale, so
+ * that the two always agree even when step does not divide the range evenly.
+ * \param start is the first value
+ * \param end is the last value that can be included
+ * \param step is the increment, which must be greater than zero
+ * \return the number of values
+ */
+size_t ScaleGeometry::steps(double start, double end, double step)
+{
+    size_t count = 0;
+
+    if(step <= 0.0)
+        return count;
+
+    for(double value = start; value <= end; value += step)
+        count++;
+
+    return count;
+}
+
+
+/*!
+ * Compute the directions of evenly spaced angles. Each direction is rotated
+ * from the one before it, except every SCALE_GEOMETRY_RESYNC steps where it is
+ * computed exactly.
+ * \param first is the first angle in degrees
+ * \param step is the change in angle from one to the next in degrees
+ * \param count is the number of angles
+ */
+void ScaleGeometry::setAngles(double first, double step, size_t count)
+{
+    const double degToRad = 3.1415926535897932384626433832795/180.0;
+
+    cosines.resize(count);
+    sines.resize(count);
+
+    double stepCos = cos(step*degToRad);
+    double stepSin = sin(step*degToRad);
+    double c = 1.0;
+    double s = 0.0;
+
+    for(size_t i = 0; i < count; i++)
+    {
+        if((i % SCALE_GEOMETRY_RESYNC) == 0)
+        {
+            double angle = (first + i*step)*degToRad;
+            c = cos(angle);
+            s = sin(angle);
+        }
+        else
+        {
+            // Rotate the previous direction by the step
+            double next = c*stepCos - s*stepSin;
+            s = s*stepCos + c*stepSin;
+            c = next;
+        }
+
+        cosines[i] = c;
+        sines[i] = s;
+    }
+
+}// ScaleGeometry::setAngles
+
+
+/*!
+ * Add a tick mark at every angle to a path
+ * \param path receives the tick marks, as one line each
+ * \param center is the center of the scale
+ * \param inner is the radius of the start of each tick mark
+ * \param outer is the radius of the end of each tick mark
+ */
+void ScaleGeometry::addTicks(QPainterPath & path, const QPointF & center, double inner, double outer) const
+{
+    for(size_t i = 0; i < cosines.size(); i++)
+    {
+        path.moveTo(point(i, center, inner));
+        path.lineTo(point(i, center, outer));
+    }
+}
+
+
+/*!
+ * Find the offset that moves a label, which is centered on its anchor, out
+ * along the direction of its angle until the edge of the label is at the
+ * anchor. The ray from the center of the label backwards along the direction
+ * leaves through the top or bottom if it is steeper than the diagonal of the
+ * label, otherwise it leaves through a side.
+ * \param index is the index of the angle
+ * \param rect is the bounding rect of the label
+ * \return the offset, in scene coordinates
+ */
+QPointF ScaleGeometry::labelOffset(size_t index, const QRectF & rect) const
+{
+    double c = cosines[index];
+    double s = sines[index];
+    double halfWidth = 0.5*rect.width();
+    double halfHeight = 0.5*rect.height();
+
+    double xoff, yoff;
+    if((c == 0.0) || (fabs(s)*halfWidth > fabs(c)*halfHeight))
+    {
+        // Through the top or bottom
+        yoff = (s >= 0.0) ? halfHeight : -halfHeight;
+        xoff = -yoff*c/s;
+    }
+    else
+    {
+        // Through the left or right side
+        xoff = (c >= 0.0) ? -halfWidth : halfWidth;
+        yoff = -xoff*s/c;
+    }
+
+    return QPointF(xoff, yoff);
+
+}// ScaleGeometry::labelOffset
@@ -0,0 +1,54 @@
+#ifndef SCALEGEOMETRY_H
+#define SCALEGEOMETRY_H
+
+#include <QPainterPath>
+#include <QPointF>
+#include <QRectF>
+#include <stddef.h>
+#include <vector>
+
+/*!
+ * \brief The ScaleGeometry class computes the directions of evenly spaced
+ * angles around a circular scale in one pass.
+ *
+ * The tick marks and labels of a dial or a roll scale are evenly spaced in
+ * angle. Rather than a sin and cos for every one, each direction is the
+ * previous direction rotated by the step, which is only multiplies and adds.
+ * An exact sin and cos every few steps keeps rounding from building up. The
+ * directions are kept in contiguous arrays, from which the tick mark end
+ * points and label offsets of the whole scale are computed. Angles follow the
+ * conventions of QPainterPath.arcMoveTo(): 0 points to the right, and the
+ * angle increases counter clockwise with y down the scene.
+ */
+class ScaleGeometry
+{
+public:
+    ScaleGeometry();
+
+    //! Compute the directions of count angles, from first in steps of step degrees
+    void setAngles(double first, double step, size_t count);
+
+    //! \return the number of steps from start to end, counted the way a loop adding step would count them
+    static size_t steps(double start, double end, double step);
+
+    //! \return the number of angles
+    size_t count(void) const {return cosines.size();}
+
+    //! \return the point at a radius from the center along the direction of an angle
+    QPointF point(size_t index, const QPointF & center, double radius) const
+    {
+        return center + QPointF(radius*cosines[index], -radius*sines[index]);
+    }
+
+    //! Add a tick mark at every angle, from the inner to the outer radius
+    void addTicks(QPainterPath & path, const QPointF & center, double inner, double outer) const;
+
+    //! \return the offset that moves a centered label back along its direction, toward the center, until its edge is at the anchor
+    QPointF labelOffset(size_t index, const QRectF & rect) const;
+
+private:
+    std::vector<double> cosines;    //!< Cosine of each angle
+    std::vector<double> sines;      //!< Sine of each angle
+};
+
+#endif // SCALEGEOMETRY_H
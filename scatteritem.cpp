@@ -0,0 +1,141 @@
+#include "scatteritem.h"
+#include <QPen>
+#include <math.h>
+#include <vector>
+
+/*!
+ * Create the item that draws the markers of a scatter plot.  This must be
+ * done on the GUI thread, as the marker sprite is a pixmap.
+ * \param input is the center of every marker, in scene coordinates
+ * \param markerColor is the color of the markers
+ * \param markerSize is the diameter of the markers in pixels, 1 or less for
+ *        single pixel markers
+ * \param parent is the parent item, which can be null
+ */
+ScatterItem::ScatterItem(const QVector<QPointF> & input, const QColor & markerColor, double markerSize, QGraphicsItem* parent) :
+    QGraphicsItem(parent),
+    points(input),
+    color(markerColor)
+{
+    if(points.isEmpty())
+        return;
+
+    // Bounds of the marker centers
+    double left = points[0].x();
+    double right = left;
+    double top = points[0].y();
+    double bottom = top;
+    for(int i = 1; i < points.size(); i++)
+    {
+        if(points[i].x() < left)
+            left = points[i].x();
+        else if(points[i].x() > right)
+            right = points[i].x();
+
+        if(points[i].y() < top)
+            top = points[i].y();
+        else if(points[i].y() > bottom)
+            bottom = points[i].y();
+    }
+
+    if(markerSize <= 1.0)
+    {
+        // Single pixel markers stick out half a pixel
+        bounds = QRectF(QPointF(left, top), QPointF(right, bottom)).adjusted(-0.5, -0.5, 0.5, 0.5);
+        return;
+    }
+
+    // Rasterize the marker once
+    int diameter = (int)ceil(markerSize);
+    sprite = QPixmap(diameter, diameter);
+    sprite.fill(Qt::transparent);
+
+    QPainter painter(&sprite);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(color);
+    painter.drawEllipse(QRectF(0, 0, diameter, diameter));
+    painter.end();
+
+    // Every marker is the whole sprite, centered on the point
+    QRectF source(0, 0, diameter, diameter);
+    fragments.reserve(points.size());
+    for(int i = 0; i < points.size(); i++)
+        fragments.append(QPainter::PixmapFragment::create(points[i], source));
+
+    double radius = 0.5*diameter;
+    bounds = QRectF(QPointF(left, top), QPointF(right, bottom)).adjusted(-radius, -radius, radius, radius);
+
+}// ScatterItem::ScatterItem
+
+
+/*!
+ * Draw all the markers, with one call to the painter.
+ * \param painter is the painter to draw with
+ * \param option is not used
+ * \param widget is not used
+ */
+void ScatterItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    if(points.isEmpty())
+        return;
+
+    if(fragments.isEmpty())
+    {
+        // A cosmetic pen of zero width is one pixel at any zoom
+        QPen pen(color);
+        pen.setWidth(0);
+        painter->setPen(pen);
+        painter->drawPoints(points.constData(), points.size());
+    }
+    else
+        painter->drawPixmapFragments(fragments.constData(), fragments.size(), sprite);
+
+}// ScatterItem::paint
+
+
+/*!
+ * Reduce a set of points to the first point in each pixel of a region.  When
+ * points overlap heavily this removes most of them, without changing what is
+ * drawn.  Points outside the region, or that are not numbers, are removed.
+ * This does not touch the scene, so it can be run on a worker thread.
+ * \param input is the points to reduce, in scene coordinates
+ * \param region is the region of the scene the points are drawn in
+ * \return the reduced points, in the same order as the input
+ */
+QVector<QPointF> ScatterItem::reducePoints(const QVector<QPointF> & input, const QRectF & region)
+{
+    QVector<QPointF> output;
+
+    QRectF rect = region.normalized();
+    if(input.isEmpty() || rect.isEmpty())
+        return output;
+
+    // One flag for every pixel of the region
+    size_t width = (size_t)ceil(rect.width()) + 1;
+    size_t height = (size_t)ceil(rect.height()) + 1;
+    std::vector<unsigned char> used(width*height, 0);
+
+    for(int i = 0; i < input.size(); i++)
+    {
+        double x = input[i].x() - rect.left();
+        double y = input[i].y() - rect.top();
+
+        // This also rejects NaN
+        if(!((x >= 0.0) && (x < width) && (y >= 0.0) && (y < height)))
+            continue;
+
+        size_t pixel = ((size_t)y)*width + (size_t)x;
+        if(used[pixel])
+            continue;
+
+        used[pixel] = 1;
+        output.append(input[i]);
+    }
+
+    return output;
+
+}// ScatterItem::reducePoints
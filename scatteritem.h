@@ -0,0 +1,47 @@
+#ifndef SCATTERITEM_H
+#define SCATTERITEM_H
+
+#include <QGraphicsItem>
+#include <QColor>
+#include <QPainter>
+#include <QPixmap>
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+
+/*!
+ * \brief The ScatterItem class draws every marker of a scatter plot as one
+ * graphics item.
+ *
+ * Single pixel markers are drawn with one call to drawPoints(). Larger
+ * markers are rasterized once into a sprite, and every marker is a fragment
+ * of one call to drawPixmapFragments(). The points are usually reduced to one
+ * per pixel first, see reducePoints().
+ */
+class ScatterItem : public QGraphicsItem
+{
+public:
+    //! Create the item for a set of points in scene coordinates
+    ScatterItem(const QVector<QPointF> & points, const QColor & color, double markerSize, QGraphicsItem* parent = 0);
+
+    //! \return the rectangle that bounds every marker
+    virtual QRectF boundingRect(void) const override {return bounds;}
+
+    //! Draw all the markers
+    virtual void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = 0) override;
+
+    //! \return the number of markers drawn
+    int markers(void) const {return points.size();}
+
+    //! Reduce points to the first point in each pixel of a region
+    static QVector<QPointF> reducePoints(const QVector<QPointF> & input, const QRectF & region);
+
+protected:
+    QVector<QPointF> points;        //!< Center of every marker
+    QVector<QPainter::PixmapFragment> fragments;   //!< One sprite fragment per marker, empty for single pixel markers
+    QPixmap sprite;                 //!< Rasterized marker
+    QColor color;                   //!< Color of the markers
+    QRectF bounds;                  //!< Rectangle that bounds every marker
+};
+
+#endif // SCATTERITEM_H
@@ -0,0 +1,578 @@
+#include "stripchartplot.h"
+#include <QGraphicsTextItem>
+
+//! Largest number of samples in one curve segment before a new segment is started
+static const size_t maxSegmentSamples = 256;
+
+StripChartPlot::StripChartPlot() :
+    TwoDimensionalPlot(),
+    xTicks(5),
+    yTicks(5),
+    xSpan(0.0),
+    capacity(1000),
+    stripAxisLayer(0),
+    clipItem(0),
+    yLayer(0),
+    rLayer(0),
+    windowOldest(0),
+    xMin(0.0),
+    xMax(1.0),
+    yMin(0.0),
+    yMax(1.0),
+    rMin(0.0),
+    rMax(1.0)
+{
+    xSamples.setCapacity(capacity);
+}
+
+
+/*!
+ * Setup the view to contain our scene.  This clears the scene, so the curves
+ * are rebuilt from the samples that are kept.
+ * \param view is the view that displays the strip chart
+ */
+void StripChartPlot::setupView(QGraphicsView* view)
+{
+    TwoDimensionalPlot::setupView(view);
+    rebuild();
+}
+
+
+/*!
+ * Set the number of samples kept for each channel.  This discards all data.
+ * \param samples is the number of samples to keep
+ */
+void StripChartPlot::setCapacity(size_t samples)
+{
+    if(samples < 2)
+        samples = 2;
+
+    capacity = samples;
+
+    xSamples.setCapacity(capacity);
+    for(size_t i = 0; i < channels.size(); i++)
+        channels[i].samples.setCapacity(capacity);
+
+    clear();
+    rebuild();
+}
+
+
+/*!
+ * Set the span of x shown.  The x axis is laid out to show this span ending
+ * a little past the newest sample.
+ * \param span is the span of x to show, use 0 to show all the samples kept
+ */
+void StripChartPlot::setXSpan(double span)
+{
+    if(span < 0.0)
+        span = 0.0;
+
+    xSpan = span;
+
+    layoutAxes();
+}
+
+
+/*!
+ * Configure the strip chart.  This discards all data.  The data of the plot
+ * data passed in is ignored, only the descriptions are used.
+ * \param plotTitle is the plot title
+ * \param xTickCount is the approximate number of desired tick marks in the x axis
+ * \param yTickCount is the approximate number of desired tick marks in the y axis
+ * \param xDescription describes the x axis
+ * \param yChannels describes each channel plotted against the y axis
+ * \param rChannels describes each channel plotted against the r axis
+ */
+void StripChartPlot::setupChart(const QString & plotTitle, uint32_t xTickCount, uint32_t yTickCount, const plotData & xDescription, const plotSet & yChannels, const plotSet & rChannels)
+{
+    title = plotTitle;
+    xTicks = xTickCount;
+    yTicks = yTickCount;
+    xAxis.title = xDescription.title;
+    xAxis.color = xDescription.color;
+    xAxis.scaler = xDescription.scaler;
+    xAxis.drawAxis = xDescription.drawAxis;
+    xAxis.labelsHigh = xDescription.labelsHigh;
+
+    xSamples.setCapacity(capacity);
+
+    channels.clear();
+    channels.resize(yChannels.size() + rChannels.size());
+    for(size_t i = 0; i < channels.size(); i++)
+    {
+        const plotData * source;
+
+        if(i < yChannels.size())
+        {
+            source = yChannels[i];
+            channels[i].right = false;
+            channels[i].input = i;
+        }
+        else
+        {
+            source = rChannels[i - yChannels.size()];
+            channels[i].right = true;
+            channels[i].input = i - yChannels.size();
+        }
+
+        // Only the description is kept, not the data
+        channels[i].description.title = source->title;
+        channels[i].description.color = source->color;
+        channels[i].description.scaler = source->scaler;
+        channels[i].description.includeZero = source->includeZero;
+        channels[i].description.drawAxis = source->drawAxis;
+        channels[i].description.drawFirstLabel = source->drawFirstLabel;
+        channels[i].description.labelsHigh = source->labelsHigh;
+        channels[i].samples.setCapacity(capacity);
+    }
+
+    clear();
+    rebuild();
+
+}// StripChartPlot::setupChart
+
+
+/*!
+ * Add new samples to every channel.  The cost is proportional to the number
+ * of new samples, unless the axes have to be laid out again.
+ * \param x is the new x samples, which must be increasing
+ * \param y has the new samples of each channel plotted against the y axis
+ * \param r has the new samples of each channel plotted against the r axis
+ */
+void StripChartPlot::append(const array & x, const std::vector<array> & y, const std::vector<array> & r)
+{
+    // Every channel must get the same number of samples, use the shortest
+    size_t count = x.size();
+    for(size_t i = 0; i < channels.size(); i++)
+    {
+        const std::vector<array> & inputs = channels[i].right ? r : y;
+
+        if(channels[i].input >= inputs.size())
+            return;
+
+        if(inputs[channels[i].input].size() < count)
+            count = inputs[channels[i].input].size();
+    }
+
+    if(count == 0)
+        return;
+
+    bool hadSamples = (xSamples.size() > 0);
+    double previousX = hadSamples ? xSamples.newest() : 0.0;
+
+    for(size_t i = 0; i < count; i++)
+        xSamples.push(x[i]);
+
+    // Sequence number of the first new sample
+    uint64_t sequence = xSamples.added() - count;
+
+    for(size_t j = 0; j < channels.size(); j++)
+    {
+        stripChannel & channel = channels[j];
+        const array & input = channel.right ? r[channel.input] : y[channel.input];
+
+        addSegment(channel, x, input, count, hadSamples, previousX);
+
+        for(size_t i = 0; i < count; i++)
+        {
+            channel.samples.push(input[i]);
+            channel.window.push(sequence + i, input[i]*channel.description.scaler);
+        }
+
+    }// for all channels
+
+    removeOldSegments();
+
+    // Drop the samples that have left the x axis from the extremes
+    slideWindows();
+    axisRanges();
+
+    // Only lay out the axes when the data run off of them
+    double newestX = xSamples.newest()*xAxis.scaler;
+    if((newestX > xMax) || (newestX < xMin) ||
+       (yRange.valid && ((yRange.low < yMin) || (yRange.high > yMax))) ||
+       (rRange.valid && ((rRange.low < rMin) || (rRange.high > rMax))))
+    {
+        layoutAxes();
+    }
+
+}// StripChartPlot::append
+
+
+/*!
+ * Add the new piece of a curve to the scene.  Short pieces are extended in
+ * place so the number of items stays small.
+ * \param channel is the channel to add the curve piece to, its samples must
+ *        not yet include the new samples
+ * \param x is the new x samples
+ * \param input is the new samples of the channel
+ * \param count is the number of new samples
+ * \param hadSamples is true if there were samples before these new ones
+ * \param previousX is the x sample before these new ones
+ */
+void StripChartPlot::addSegment(stripChannel & channel, const array & x, const array & input, size_t count, bool hadSamples, double previousX)
+{
+    double xScaler = xAxis.scaler;
+    double scaler = channel.description.scaler;
+    uint64_t last = xSamples.added() - 1;
+
+    // Extend the newest piece if it is still short
+    if(!channel.segments.empty() && (channel.segments.back().samples + count <= maxSegmentSamples))
+    {
+        stripSegment & segment = channel.segments.back();
+        QPainterPath path = segment.item->path();
+
+        for(size_t i = 0; i < count; i++)
+            path.lineTo(x[i]*xScaler, input[i]*scaler);
+
+        segment.item->setPath(path);
+        segment.last = last;
+        segment.samples += count;
+        return;
+    }
+
+    // Start a new piece, connected to the previous sample
+    QPainterPath path;
+    size_t start = 0;
+    if(hadSamples && (channel.samples.size() > 0))
+        path.moveTo(previousX*xScaler, channel.samples.newest()*scaler);
+    else
+    {
+        path.moveTo(x[0]*xScaler, input[0]*scaler);
+        start = 1;
+    }
+
+    for(size_t i = start; i < count; i++)
+        path.lineTo(x[i]*xScaler, input[i]*scaler);
+
+    stripSegment segment;
+    segment.item = myScene.addPath(path, channelPen(channel));
+    segment.item->setParentItem(channel.right ? rLayer : yLayer);
+    segment.last = last;
+    segment.samples = count;
+    channel.segments.push_back(segment);
+
+}// StripChartPlot::addSegment
+
+
+/*!
+ * Remove curve pieces whose samples have all left the ring.  Pieces to the
+ * left of the x axis are kept, hidden by the clip, so they are back in view
+ * if the span is widened.  The ring bounds how many are kept.
+ */
+void StripChartPlot::removeOldSegments(void)
+{
+    uint64_t oldest = xSamples.oldestSequence();
+
+    for(size_t j = 0; j < channels.size(); j++)
+    {
+        std::deque<stripSegment> & segments = channels[j].segments;
+
+        // Always keep the newest piece, it is the one that gets extended
+        while((segments.size() > 1) && (segments.front().last < oldest))
+        {
+            delete segments.front().item;
+            segments.pop_front();
+        }
+    }
+
+}// StripChartPlot::removeOldSegments
+
+
+/*!
+ * Build the pen for a channel.  The curves are drawn in data coordinates, so
+ * the pen must be cosmetic to keep its width independent of the transform.
+ * \param channel is the channel to draw
+ * \return the pen for the channel
+ */
+QPen StripChartPlot::channelPen(const stripChannel & channel) const
+{
+    QPen pen(channel.description.color);
+    pen.setCosmetic(true);
+    return pen;
+}
+
+
+/*!
+ * Rebuild all the items of the strip chart after the scene has been cleared.
+ * The curves are rebuilt from the samples in the rings.
+ */
+void StripChartPlot::rebuild(void)
+{
+    // The scene has been cleared, so these are gone
+    stripAxisLayer = 0;
+
+    // Curves are clipped to the grid, and live in data coordinates
+    clipItem = myScene.addRect(QRectF(), QPen(Qt::NoPen));
+    clipItem->setFlag(QGraphicsItem::ItemClipsChildrenToShape);
+    clipItem->setZValue(1.0);
+
+    yLayer = myScene.addRect(QRectF(), QPen(Qt::NoPen));
+    yLayer->setParentItem(clipItem);
+
+    rLayer = myScene.addRect(QRectF(), QPen(Qt::NoPen));
+    rLayer->setParentItem(clipItem);
+
+    for(size_t j = 0; j < channels.size(); j++)
+    {
+        stripChannel & channel = channels[j];
+        channel.segments.clear();
+        channel.window.clear();
+
+        size_t length = channel.samples.size();
+        if(xSamples.size() < length)
+            length = xSamples.size();
+
+        // The samples in the ring are rebuilt into pieces of limited size
+        for(size_t first = 0; first + 1 < length; first += maxSegmentSamples)
+        {
+            size_t last = first + maxSegmentSamples;
+            if(last >= length)
+                last = length - 1;
+
+            QPainterPath path;
+            path.moveTo(xSamples.at(first)*xAxis.scaler, channel.samples.at(first)*channel.description.scaler);
+            for(size_t i = first + 1; i <= last; i++)
+                path.lineTo(xSamples.at(i)*xAxis.scaler, channel.samples.at(i)*channel.description.scaler);
+
+            stripSegment segment;
+            segment.item = myScene.addPath(path, channelPen(channel));
+            segment.item->setParentItem(channel.right ? rLayer : yLayer);
+            segment.last = xSamples.oldestSequence() + last;
+            segment.samples = last - first;
+            channel.segments.push_back(segment);
+
+        }// for all pieces of the curve
+
+        for(size_t i = 0; i < length; i++)
+            channel.window.push(xSamples.oldestSequence() + i, channel.samples.at(i)*channel.description.scaler);
+
+    }// for all channels
+
+    // The windows hold every sample in the rings
+    windowOldest = xSamples.oldestSequence();
+
+    layoutAxes();
+
+}// StripChartPlot::rebuild
+
+
+/*!
+ * Find the oldest sample that is still on the x axis.  Samples that have left
+ * the ring, or whose x value is before the start of the x axis, are outside
+ * the window used for autoscaling.
+ * \return the sequence number of the oldest sample on the x axis
+ */
+uint64_t StripChartPlot::windowStart(void) const
+{
+    // Binary search for the first x on the axis, x is increasing
+    size_t low = 0;
+    size_t high = xSamples.size();
+    while(low < high)
+    {
+        size_t mid = low + (high - low)/2;
+        if(xSamples.at(mid)*xAxis.scaler < xMin)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return xSamples.oldestSequence() + low;
+
+}// StripChartPlot::windowStart
+
+
+/*!
+ * Move the start of the extremes of every channel to the start of the x axis.
+ * Samples that are no longer on the x axis are removed.  If the x axis now
+ * starts earlier, as when the span is widened, the samples removed before are
+ * gone from the windows, so they are filled again from the rings.
+ */
+void StripChartPlot::slideWindows(void)
+{
+    uint64_t oldest = windowStart();
+
+    if(oldest < windowOldest)
+    {
+        size_t length = xSamples.size();
+        size_t first = (size_t)(oldest - xSamples.oldestSequence());
+
+        for(size_t j = 0; j < channels.size(); j++)
+        {
+            stripChannel & channel = channels[j];
+            channel.window.clear();
+
+            size_t last = length;
+            if(channel.samples.size() < last)
+                last = channel.samples.size();
+
+            for(size_t i = first; i < last; i++)
+                channel.window.push(xSamples.oldestSequence() + i, channel.samples.at(i)*channel.description.scaler);
+        }
+    }
+    else
+    {
+        for(size_t j = 0; j < channels.size(); j++)
+            channels[j].window.evict(oldest);
+    }
+
+    windowOldest = oldest;
+
+}// StripChartPlot::slideWindows
+
+
+//! Combine the extremes of every channel into the extremes of the y and r axis
+void StripChartPlot::axisRanges(void)
+{
+    yRange = stripRange();
+    rRange = stripRange();
+
+    for(size_t j = 0; j < channels.size(); j++)
+    {
+        const stripChannel & channel = channels[j];
+        stripRange & range = channel.right ? rRange : yRange;
+
+        if(channel.window.isEmpty())
+            continue;
+
+        range.include(channel.window.minimum());
+        range.include(channel.window.maximum());
+
+        if(channel.description.includeZero)
+            range.include(0.0);
+    }
+
+}// StripChartPlot::axisRanges
+
+
+/*!
+ * Lay out the grid, axes, and title, and update the transforms that map the
+ * curves from data coordinates to the scene.  The curves themselves are not
+ * touched.
+ */
+void StripChartPlot::layoutAxes(void)
+{
+    if(clipItem == 0)
+        return;
+
+    QRectF region = size;
+
+    // Origin of the grid in pixels
+    double yOrg = region.bottom();
+    double xOrg = region.left();
+
+    // The x axis covers the span, ending one tick past the newest sample, so
+    //   it only needs to be laid out again once per tick
+    double newest = 0.0;
+    double oldest = 0.0;
+    if(xSamples.size() > 0)
+    {
+        newest = xSamples.newest()*xAxis.scaler;
+        oldest = xSamples.at(0)*xAxis.scaler;
+    }
+
+    double span = xSpan;
+    if(span <= 0.0)
+        span = newest - oldest;
+    if(span <= 0.0)
+        span = 1.0;
+
+    uint32_t numXticks = xTicks;
+    int32_t xdigits = TwoDimensionalScene::tickMarks(newest - span, newest + span/(xTicks > 0 ? xTicks : 1), &numXticks, &xMin, &xMax);
+
+    // The extremes of the y and r data on the new x axis
+    slideWindows();
+    axisRanges();
+
+    // Tick mark spacing details for the Y axis
+    uint32_t numYticks = yTicks;
+    int32_t ydigits = 0;
+    yMin = 0.0;
+    yMax = 1.0;
+    if(yRange.valid)
+        ydigits = TwoDimensionalScene::tickMarks(yRange.low, yRange.high, &numYticks, &yMin, &yMax);
+
+    // Tick mark spacing details for the R axis
+    uint32_t numRticks = yTicks;
+    int32_t rdigits = 0;
+    rMin = 0.0;
+    rMax = 1.0;
+    if(rRange.valid)
+        rdigits = TwoDimensionalScene::tickMarks(rRange.low, rRange.high, &numRticks, &rMin, &rMax);
+
+    // Choose the larger of the two tick marks values, and then re-run the
+    //   other axis spacing, with a fixed number of tick marks
+    if(numYticks > numRticks)
+    {
+        numRticks = numYticks;
+        if(rRange.valid)
+            rdigits = TwoDimensionalScene::tickMarks(rRange.low, rRange.high, numRticks, &rMin, &rMax);
+    }
+    else if(numRticks > numYticks)
+    {
+        numYticks = numRticks;
+        if(yRange.valid)
+            ydigits = TwoDimensionalScene::tickMarks(yRange.low, yRange.high, numYticks, &yMin, &yMax);
+    }
+
+    // Figure out graph scaling, remember top - bottom is a negative number
+    double xScale = region.width()/(xMax - xMin);
+    double yScale = region.height()/(yMin - yMax);
+    double rScale = region.height()/(rMin - rMax);
+
+    // Replace the old axes, the curves are clipped to the grid so only the
+    //   axes count towards the drawn bounds
+    delete stripAxisLayer;
+    bounds = QRectF();
+    stripAxisLayer = myScene.addRect(QRectF(), QPen(Qt::NoPen));
+    setLayer(stripAxisLayer);
+
+    // Assemble the plot sets that describe the y and r axis
+    plotSet yData, rData;
+    for(size_t j = 0; j < channels.size(); j++)
+    {
+        if(channels[j].right)
+            rData.push_back(&channels[j].description);
+        else
+            yData.push_back(&channels[j].description);
+    }
+
+    // Draw the grid lines
+    drawGrid(xOrg, yOrg, xScale, xMin, xMax, numXticks*2, yScale, yMin, yMax, numYticks*2);
+
+    // The X axis and its tick marks and labels
+    if(xAxis.drawAxis)
+        DrawHorizontalAxis(xOrg, yOrg, xScale, xMin, xMax, numXticks, xAxis.title, xdigits, xAxis.color, xAxis.labelsHigh);
+
+    // The left vertical (Y) axis and its tick marks and lables
+    if(yData.size() > 0)
+        DrawVerticalAxis(xOrg, yOrg, yScale, yMin, yMax, numYticks, labelsFromPlotSet(yData), ydigits, colorsFromPlotSet(yData), !yData.at(0)->labelsHigh, drawFirstLabelFromPlotSet(yData));
+
+    // The right vertical (R) axis and its tick marks and lables
+    if(rData.size() > 0)
+        DrawVerticalAxis(region.right(), yOrg, rScale, rMin, rMax, numRticks, labelsFromPlotSet(rData), rdigits, colorsFromPlotSet(rData), rData.at(0)->labelsHigh, drawFirstLabelFromPlotSet(rData));
+
+    // Add the title to the plot
+    if(!title.isEmpty())
+    {
+        QPointF pos;
+        QGraphicsTextItem* item = addText(title);
+
+        // Title is centered at the top
+        pos.setY(region.top());
+        pos.setX((region.left()+region.right())*0.5);
+        pos += rectOffsetForTopCenter(item->boundingRect());
+        placeText(item, pos);
+    }
+
+    setLayer(0);
+
+    // The curves scroll and scale by changing the transform of their layers
+    clipItem->setRect(QRectF(QPointF(xOrg, yOrg - region.height()), QPointF(xOrg + region.width(), yOrg)));
+    yLayer->setTransform(QTransform(xScale, 0, 0, yScale, xOrg - xMin*xScale, yOrg - yMin*yScale));
+    rLayer->setTransform(QTransform(xScale, 0, 0, rScale, xOrg - xMin*xScale, yOrg - rMin*rScale));
+
+    fitAllInView();
+
+}// StripChartPlot::layoutAxes
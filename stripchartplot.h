@@ -0,0 +1,280 @@
+#ifndef STRIPCHARTPLOT_H
+#define STRIPCHARTPLOT_H
+
+#include "twodimensionalplot.h"
+#include <QGraphicsPathItem>
+#include <QGraphicsRectItem>
+#include <deque>
+#include <stdint.h>
+
+//! A fixed capacity ring of samples, the oldest samples are overwritten first
+class ringBuffer
+{
+public:
+    ringBuffer() :
+        head(0), count(0), total(0)
+    {
+    }
+
+    //! Set the number of samples the ring holds, discarding all samples
+    void setCapacity(size_t samples) {buffer.assign(samples, 0.0); clear();}
+
+    //! Discard all samples
+    void clear(void) {head = count = 0; total = 0;}
+
+    //! \return the number of samples the ring can hold
+    size_t capacity(void) const {return buffer.size();}
+
+    //! \return the number of samples in the ring
+    size_t size(void) const {return count;}
+
+    //! \return a sample in the ring, index 0 is the oldest sample
+    double at(size_t index) const
+    {
+        size_t i = head + index;
+        if(i >= buffer.size())
+            i -= buffer.size();
+        return buffer[i];
+    }
+
+    //! \return the newest sample in the ring, which must not be empty
+    double newest(void) const {return at(count - 1);}
+
+    //! \return the number of samples ever added, which is one more than the sequence number of the newest sample
+    uint64_t added(void) const {return total;}
+
+    //! \return the sequence number of the oldest sample in the ring
+    uint64_t oldestSequence(void) const {return total - count;}
+
+    //! Add a sample to the ring, overwriting the oldest sample if the ring is full
+    void push(double value)
+    {
+        if(buffer.empty())
+            return;
+
+        if(count < buffer.size())
+        {
+            size_t i = head + count;
+            if(i >= buffer.size())
+                i -= buffer.size();
+            buffer[i] = value;
+            count++;
+        }
+        else
+        {
+            buffer[head] = value;
+            head++;
+            if(head >= buffer.size())
+                head = 0;
+        }
+
+        total++;
+    }
+
+private:
+    array buffer;   //!< Storage for the samples
+    size_t head;    //!< Index of the oldest sample
+    size_t count;   //!< Number of samples in the ring
+    uint64_t total; //!< Number of samples ever added
+};
+
+
+//! A sample in a sliding window, tagged with its sequence number
+class windowSample
+{
+public:
+    uint64_t sequence;  //!< Sequence number of the sample
+    double value;       //!< Value of the sample
+};
+
+
+/*!
+ * \brief The slidingExtremes class tracks the minimum and maximum of a sliding
+ * window of samples.
+ *
+ * Each extreme is kept as a monotonic deque: a sample is dropped as soon as a
+ * newer sample is at least as extreme, since it can never be the extreme of
+ * the window again. The front of each deque is the extreme of the window.
+ * Every sample is pushed and popped at most once, so the cost is amortized
+ * O(1) per sample, no matter how long the window is.
+ */
+class slidingExtremes
+{
+public:
+    //! Discard all samples
+    void clear(void) {lows.clear(); highs.clear();}
+
+    //! \return true if there are no samples in the window
+    bool isEmpty(void) const {return highs.empty();}
+
+    //! \return the smallest sample in the window, which must not be empty
+    double minimum(void) const {return lows.front().value;}
+
+    //! \return the largest sample in the window, which must not be empty
+    double maximum(void) const {return highs.front().value;}
+
+    //! Add a sample to the window, sequence numbers must increase
+    void push(uint64_t sequence, double value)
+    {
+        // NaN is not data, and would break the ordering of the deques
+        if(value != value)
+            return;
+
+        windowSample sample = {sequence, value};
+
+        while(!lows.empty() && (lows.back().value >= value))
+            lows.pop_back();
+        lows.push_back(sample);
+
+        while(!highs.empty() && (highs.back().value <= value))
+            highs.pop_back();
+        highs.push_back(sample);
+    }
+
+    //! Remove all samples whose sequence number is older than oldest from the window
+    void evict(uint64_t oldest)
+    {
+        while(!lows.empty() && (lows.front().sequence < oldest))
+            lows.pop_front();
+
+        while(!highs.empty() && (highs.front().sequence < oldest))
+            highs.pop_front();
+    }
+
+private:
+    std::deque<windowSample> lows;  //!< Increasing values, the front is the minimum
+    std::deque<windowSample> highs; //!< Decreasing values, the front is the maximum
+};
+
+
+//! The extremes of data on one axis
+class stripRange
+{
+public:
+    stripRange() :
+        valid(false), low(0.0), high(1.0)
+    {
+    }
+
+    //! Grow the range to include a value
+    void include(double value)
+    {
+        if(!valid)
+        {
+            low = high = value;
+            valid = true;
+        }
+        else if(value < low)
+            low = value;
+        else if(value > high)
+            high = value;
+    }
+
+    bool valid;     //!< True if the range has any data
+    double low;     //!< The smallest value
+    double high;    //!< The largest value
+};
+
+
+//! A piece of a strip chart curve, in data coordinates
+class stripSegment
+{
+public:
+    QGraphicsPathItem* item;    //!< The item that draws this piece
+    uint64_t last;              //!< Sequence number of the last sample in the piece
+    size_t samples;             //!< Number of samples in the piece
+};
+
+
+//! One channel of a strip chart
+class stripChannel
+{
+public:
+    plotData description;               //!< Title, color, scaler, and axis options of the channel
+    bool right;                         //!< True if the channel is plotted against the right axis
+    size_t input;                       //!< Index of the channel in the y or r arrays given to append()
+    ringBuffer samples;                 //!< The most recent samples
+    slidingExtremes window;             //!< Scaled extremes of the samples on the x axis
+    std::deque<stripSegment> segments;  //!< Pieces of the curve, oldest first
+};
+
+
+/*!
+ * \brief The StripChartPlot class is a TwoDimensionalPlot for live data.
+ *
+ * New samples are appended to a fixed capacity ring buffer per channel. Each
+ * append only adds the new piece of each curve to the scene. The curves are
+ * kept in data coordinates and the view scrolls by changing the transform of
+ * their layer. The grid, axes, and labels are only laid out again when the
+ * newest x value runs off the end of the x axis, or the autoscaled data leave
+ * the y or r axis. The extremes of the samples on the x axis are tracked
+ * incrementally, so autoscaling does not rescan the window. The x data must
+ * be increasing. The strip chart keeps pointers to its items, so the plot
+ * functions of TwoDimensionalPlot, which clear the scene, are not inherited
+ * publicly.
+ */
+class StripChartPlot : protected TwoDimensionalPlot
+{
+public:
+    StripChartPlot();
+
+    //! Setup the view to contain our scene
+    virtual void setupView(QGraphicsView* view) override;
+
+    using TwoDimensionalScene::getDrawnBounds;
+    using TwoDimensionalScene::exportTiled;
+    using TwoDimensionalPlot::fitAllInView;
+
+    //! \return the number of samples kept for each channel
+    size_t getCapacity(void) const {return capacity;}
+
+    //! \return the span of x shown, 0 to show all the samples kept
+    double getXSpan(void) const {return xSpan;}
+
+    //! Set the number of samples kept for each channel, discarding all data
+    void setCapacity(size_t samples);
+
+    //! Set the span of x shown, 0 to show all the samples kept
+    void setXSpan(double span);
+
+    //! Configure the title, axes, and channels, discarding all data
+    void setupChart(const QString & plotTitle, uint32_t xTickCount, uint32_t yTickCount, const plotData & xDescription, const plotSet & yChannels, const plotSet & rChannels);
+
+    //! Add new samples to every channel
+    void append(const array & x, const std::vector<array> & y, const std::vector<array> & r = std::vector<array>());
+
+protected:
+    void rebuild(void);
+    void layoutAxes(void);
+    uint64_t windowStart(void) const;
+    void slideWindows(void);
+    void axisRanges(void);
+    void addSegment(stripChannel & channel, const array & x, const array & input, size_t count, bool hadSamples, double previousX);
+    void removeOldSegments(void);
+    QPen channelPen(const stripChannel & channel) const;
+
+protected:
+    QString title;                  //!< The plot title
+    uint32_t xTicks;                //!< Approximate number of x axis tick marks
+    uint32_t yTicks;                //!< Approximate number of y axis tick marks
+    double xSpan;                   //!< Span of x shown, 0 to show all the samples
+    size_t capacity;                //!< Number of samples kept for each channel
+    plotData xAxis;                 //!< Title, color, and scaler of the x axis
+    ringBuffer xSamples;            //!< The most recent x samples
+    std::vector<stripChannel> channels; //!< All the y and r channels
+    stripRange yRange;              //!< Extremes of the y channels on the x axis
+    stripRange rRange;              //!< Extremes of the r channels on the x axis
+    QGraphicsRectItem* stripAxisLayer;  //!< Parent of the grid, axes, and title
+    QGraphicsRectItem* clipItem;    //!< Clips the curves to the grid
+    QGraphicsRectItem* yLayer;      //!< Parent of the y curves, transforms data to the scene
+    QGraphicsRectItem* rLayer;      //!< Parent of the r curves, transforms data to the scene
+    uint64_t windowOldest;          //!< Sequence number of the oldest sample the windows were filled from
+    double xMin;                    //!< Start of the x axis
+    double xMax;                    //!< End of the x axis
+    double yMin;                    //!< Start of the y axis
+    double yMax;                    //!< End of the y axis
+    double rMin;                    //!< Start of the r axis
+    double rMax;                    //!< End of the r axis
+};
+
+#endif // STRIPCHARTPLOT_H
@@ -0,0 +1,459 @@
+#include "tapegaugescene.h"
+#include <QFontMetricsF>
+#include <QGraphicsScene>
+#include <QGraphicsTextItem>
+#include <QList>
+#include <math.h>
+
+//! Most windows of tape built whole, a longer tape is built as a segment around the reading
+static const int maximumTapeWindows = 32;
+
+//! Windows of a segment on either side of the window around the reading
+static const int segmentWindows = 3;
+
+TapeGaugeScene::TapeGaugeScene() :
+    LinearGaugeScene(),
+    visibleRange(40.0),
+    wrapping(false),
+    pixelsPerUnit(1.0),
+    tapeStart(0.0),
+    tapeLength(0.0),
+    tapeEnd(0.0),
+    windowRange(0.0),
+    windowed(false),
+    clipItem(0),
+    tapeLayer(0)
+{
+}
+
+
+/*!
+ * Set the range of the scale visible in the window.  The window is the height
+ * of the scene, so this sets the pixels per unit of the tape.
+ * \param range is the visible range, use 0 (or a range larger than the scale)
+ *        to show the whole scale
+ */
+void TapeGaugeScene::setVisibleRange(double range)
+{
+    if(range < 0.0)
+        range = 0.0;
+
+    visibleRange = range;
+    dirty = true;
+}
+
+
+/*!
+ * Set if the scale wraps around from the top back to the start, like a
+ * heading from 0 to 360.  The total range should be a multiple of the major
+ * spacing, so the ticks line up from one period to the next.
+ * \param wrap should be true for a scale that wraps around
+ */
+void TapeGaugeScene::setWrapping(bool wrap)
+{
+    wrapping = wrap;
+    dirty = true;
+}
+
+
+/*!
+ * Draw the gauge reading, assume all other drawing is done and good.  Only
+ * the tape layer is moved, and the readout text changed.
+ * \param scene will be updated with the new reading
+ */
+void TapeGaugeScene::updateReading(QGraphicsScene& scene)
+{
+    moveTape();
+    buildReadingLabel(scene);
+}
+
+
+/*!
+ * Find where the reading is on the tape.  A reading off the end of a scale
+ * that does not wrap is held at the end.  For a scale that wraps, the reading
+ * is moved into the middle period of a whole tape, or into the period nearest
+ * the middle of a segment.
+ * \return the reading in the scale values of the tape
+ */
+double TapeGaugeScene::tapeReading(void) const
+{
+    double range = getTotalRange();
+    double reading = gaugeReading;
+
+    if(wrapping && (range > 0.0))
+    {
+        reading = fmod(reading - scaleStart, range);
+        if(reading < 0.0)
+            reading += range;
+        reading += scaleStart;
+
+        if(windowed)
+        {
+            double center = 0.5*(tapeStart + tapeEnd);
+            reading += range*floor((center - reading)/range + 0.5);
+        }
+    }
+    else if(reading < scaleStart)
+        reading = scaleStart;
+    else if(reading > getTopOfScale())
+        reading = getTopOfScale();
+
+    return reading;
+
+}// TapeGaugeScene::tapeReading
+
+
+/*!
+ * Move the tape so the reading is at the center of the window.  If the tape
+ * is a segment, and the reading is within a window of an end of the segment
+ * that is not the end of the scale, the segment is built again around the
+ * reading first.
+ */
+void TapeGaugeScene::moveTape(void)
+{
+    if(tapeLayer == 0)
+        return;
+
+    double reading = tapeReading();
+
+    if(windowed)
+    {
+        bool lowEnd = !wrapping && (tapeStart <= scaleStart);
+        bool highEnd = !wrapping && (tapeEnd >= getTopOfScale());
+
+        if(((reading - tapeStart < windowRange) && !lowEnd) || ((tapeEnd - reading < windowRange) && !highEnd))
+        {
+            // Around the reading in the real scale, so the segment does not drift
+            windowed = false;
+            fillTape(tapeReading());
+            reading = tapeReading();
+        }
+    }
+
+    // The tape runs up from its start at the bottom of the layer
+    double y = tapeLength - (reading - tapeStart)*pixelsPerUnit;
+
+    tapeLayer->setPos(0, 0.5*size.height() - y);
+
+}// TapeGaugeScene::moveTape
+
+
+//! \return the range the number of tick marks is limited over
+double TapeGaugeScene::tickRange(void) const
+{
+    if(windowed)
+        return (2*segmentWindows + 2)*windowRange;
+    else
+        return getTotalRange();
+}
+
+
+/*!
+ * Replace the ticks and labels of the tape layer with a new tape.  The tape
+ * is built in a scene of its own and its items are moved into the layer.
+ * \param center is the scale value the tape is built around, which only
+ *        matters if the tape is a segment
+ */
+void TapeGaugeScene::fillTape(double center)
+{
+    qDeleteAll(tapeLayer->childItems());
+
+    QGraphicsScene tape;
+    buildTape(tape, center);
+
+    QList<QGraphicsItem*> tapeItems = tape.items();
+    for(int i = 0; i < tapeItems.size(); i++)
+        tapeItems[i]->setParentItem(tapeLayer);
+
+}// TapeGaugeScene::fillTape
+
+
+/*!
+ * Find the smallest multiple of one spacing that is also a multiple of
+ * another, so that ticks of both spacings started there land where they
+ * would if started at the start of the scale.
+ * \param a is one spacing
+ * \param b is the other spacing
+ * \return the common multiple, or 0 if there is no small one
+ */
+static double commonMultiple(double a, double b)
+{
+    for(int k = 1; k <= 1000; k++)
+    {
+        double ratio = k*a/b;
+        if(fabs(ratio - floor(ratio + 0.5)) < 1e-6*ratio)
+            return k*a;
+    }
+
+    return 0.0;
+}
+
+
+/*!
+ * Build the ticks and labels of the tape, in tape coordinates.  The tick mark
+ * builders of LinearGaugeScene lay out the whole scale along the size of the
+ * scene, so for the duration of the build the size is the size of the tape,
+ * and the scale is the part of the scale on the tape.  For a wrapping tape
+ * that is three periods.  If that would be more than maximumTapeWindows
+ * windows long the tape is instead a segment of about 2*segmentWindows + 1
+ * windows around the center, which also keeps the length in pixels in range.
+ * The segment starts on a multiple of the tick and label spacings from the
+ * start of the scale, so every segment has the same ticks.
+ * \param scene receives the tape, which must be empty before this is called
+ * \param center is the scale value the tape is built around, if it is a segment
+ */
+void TapeGaugeScene::buildTape(QGraphicsScene& scene, double center)
+{
+    double range = getTotalRange();
+    if(range <= 0.0)
+        return;
+
+    double window = visibleRange;
+    if((window <= 0.0) || (window > range))
+        window = range;
+
+    windowRange = window;
+    pixelsPerUnit = size.height()/window;
+
+    // The part of the scale on the tape
+    double start = scaleStart;
+    double length = range;
+    if(wrapping)
+    {
+        // One period below and one above the real scale
+        start = scaleStart - range;
+        length = 3.0*range;
+    }
+
+    windowed = (length > maximumTapeWindows*window);
+    if(windowed)
+    {
+        // The spacings the builders will use, see tickRange()
+        double ticks = tickRange();
+        double major = spacingForPixels(majorSpacing, ticks, pixelsPerUnit, minimumTickPitch);
+        double labels = spacingForPixels(major, ticks, pixelsPerUnit, QFontMetricsF(QFont()).height());
+        double minor = spacingForPixels(minorSpacing, ticks, pixelsPerUnit, minimumTickPitch);
+
+        double period = labels;
+        if(drawMinorTicks(minor, minorSpacing, major))
+            period = (labels > 0.0) ? commonMultiple(labels, minor) : minor;
+
+        // A period too long to leave a window either side is not kept
+        if(period > (2*segmentWindows + 1)*window)
+            period = 0.0;
+
+        length = (2*segmentWindows + 1)*window + period;
+        start = center - (segmentWindows + 0.5)*window;
+        if(period > 0.0)
+            start = scaleStart + floor((start - scaleStart)/period)*period;
+
+        if(!wrapping)
+        {
+            if(start + length > getTopOfScale())
+            {
+                // Ends at the top of the scale
+                start = getTopOfScale() - length;
+                if(period > 0.0)
+                    start = scaleStart + ceil((start - scaleStart)/period)*period;
+                length = getTopOfScale() - start;
+            }
+
+            if(start < scaleStart)
+                start = scaleStart;
+        }
+    }
+
+    // Save the configuration that is changed for the build
+    QRect savedSize = size;
+    double savedStart = scaleStart;
+    double savedLow = scaleLowRange;
+    double savedMid = scaleMidRange;
+    double savedHigh = scaleHighRange;
+
+    tapeStart = start;
+    tapeEnd = start + length;
+    if(!wrapping && (tapeEnd > getTopOfScale()))
+        tapeEnd = getTopOfScale();
+
+    scaleStart = tapeStart;
+    scaleLowRange = tapeEnd - tapeStart;
+    scaleMidRange = scaleHighRange = 0.0;
+
+    // At most maximumTapeWindows windows, so this fits in an int
+    size = QRect(0, 0, savedSize.width(), (int)ceil((tapeEnd - tapeStart)*pixelsPerUnit));
+    tapeLength = size.height();
+    pixelsPerUnit = tapeLength/(tapeEnd - tapeStart);
+
+    buildMinorTicks(scene);
+    buildMajorTicks(scene);
+    buildTapeLabels(scene, savedStart, range);
+
+    size = savedSize;
+    scaleStart = savedStart;
+    scaleLowRange = savedLow;
+    scaleMidRange = savedMid;
+    scaleHighRange = savedHigh;
+
+}// TapeGaugeScene::buildTape
+
+
+/*!
+ * Build a label at every major tick of the tape, centered on the tick.  Unlike
+ * the labels of a fixed scale the end labels are not pulled in, since the ends
+ * of the tape scroll into the middle of the window.  For a wrapping scale the
+ * labels show the value in the real scale.
+ * \param scene is updated with the labels
+ * \param realStart is the start of the real scale
+ * \param period is the range of the real scale
+ */
+void TapeGaugeScene::buildTapeLabels(QGraphicsScene& scene, double realStart, double period)
+{
+    // Setting the tick mark length to 0 prevents drawing
+    if((majorTickMarkLength <= 0.0) || (majorSpacing <= 0.0) || (tickMarkLabelEnable == false))
+        return;
+
+    double endScale = getTopOfScale();
+
+    // This is where the text starts, just past the tick marks
+    double moveLength = size.width()*majorTickMarkLength + 2.0;
+
+    // Labels on major ticks, but at least a line apart
+    double spacing = spacingForPixels(majorSpacing, tickRange(), pixelsPerUnit, minimumTickPitch);
+    spacing = spacingForPixels(spacing, tickRange(), pixelsPerUnit, QFontMetricsF(QFont()).height());
+
+    for(double scale = scaleStart; scale <= endScale; scale += spacing)
+    {
+        double value = scale;
+        if(wrapping)
+        {
+            // The label of the real scale, the top of the scale is the start
+            value = fmod(scale - realStart, period);
+            if(value < 0.0)
+                value += period;
+            value += realStart;
+        }
+
+        QString text = QString("%1").arg(value, 0, 'f', tickMarkPrecision);
+        QGraphicsTextItem* item = scene.addText(text, QFont());
+        item->setDefaultTextColor(tickMarkColor);
+
+        QRectF rect = item->boundingRect();
+        QPointF location;
+
+        if(ticksRightOrBottom)
+        {
+            // Ticks on the right, labels to their left
+            location = QPointF(size.width() - moveLength, scaleToPixel(scale));
+            location += rectOffsetForRightCenter(rect);
+        }
+        else
+        {
+            // Ticks on the left, labels to their right
+            location = QPointF(moveLength, scaleToPixel(scale));
+            location += rectOffsetForLeftCenter(rect);
+        }
+
+        item->setPos(location);
+    }
+
+}// TapeGaugeScene::buildTapeLabels
+
+
+/*!
+ * Build the fixed readout box at the center of the window, with a pointer at
+ * the tick marks.  The reading text is centered in the box.
+ * \param scene receives the readout
+ */
+void TapeGaugeScene::buildReadout(QGraphicsScene& scene)
+{
+    double center = 0.5*size.height();
+    double height = QFontMetricsF(QFont()).height() + 6.0;
+    double pointer = 0.5*height;
+
+    QColor fill = backgroundColor;
+    if(fill.alpha() == 0)
+        fill = Qt::white;
+
+    QPen pen(tickMarkColor);
+    pen.setWidthF(1.5);
+
+    // The box leaves room on the tick side for the pointer
+    QPainterPath path;
+    if(ticksRightOrBottom)
+    {
+        double right = size.width() - pointer;
+        path.moveTo(0, center - 0.5*height);
+        path.lineTo(right, center - 0.5*height);
+        path.lineTo(size.width(), center);
+        path.lineTo(right, center + 0.5*height);
+        path.lineTo(0, center + 0.5*height);
+        path.closeSubpath();
+    }
+    else
+    {
+        path.moveTo(size.width(), center - 0.5*height);
+        path.lineTo(pointer, center - 0.5*height);
+        path.lineTo(0, center);
+        path.lineTo(pointer, center + 0.5*height);
+        path.lineTo(size.width(), center + 0.5*height);
+        path.closeSubpath();
+    }
+
+    // Added after the tape, so it is drawn over it
+    scene.addPath(path, pen, QBrush(fill));
+
+    // The reading text goes in the middle of the box, and is added after it
+    readingAnchor = QPointF(0.5*size.width(), center);
+    readingAlignment = Qt::AlignCenter;
+
+}// TapeGaugeScene::buildReadout
+
+
+/*!
+ * Create the scene, redrawing all elements
+ * \param scene will be cleared and then completely rebuilt
+ */
+void TapeGaugeScene::createScene(QGraphicsScene& scene)
+{
+    // Set the background
+    scene.setBackgroundBrush(backgroundColor);
+
+    // remove all items currently in the scene
+    scene.clear();
+
+    // Set the size of the scene
+    scene.setSceneRect(0, 0, size.width(), size.height());
+
+    // Does not exist now
+    rectItem = 0;
+    fillItem = 0;
+    fillItem2 = 0;
+    clipItem = 0;
+    tapeLayer = 0;
+
+    // The tape is always vertical
+    horizontal = false;
+    selectOrientation();
+    layoutReadingLabel();
+
+    // The window that the tape scrolls through
+    clipItem = scene.addRect(0, 0, size.width(), size.height(), QPen(Qt::NoPen), QBrush());
+    clipItem->setFlag(QGraphicsItem::ItemClipsChildrenToShape);
+
+    tapeLayer = scene.addRect(QRectF(), QPen(Qt::NoPen), QBrush());
+    tapeLayer->setParentItem(clipItem);
+
+    // The reading in the real scale, until the tape is built
+    windowed = false;
+    fillTape(tapeReading());
+
+    // The readout and pointer are fixed over the tape
+    buildReadout(scene);
+
+    // No longer dirty
+    dirty = false;
+
+    // The variable stuff
+    updateReading(scene);
+
+}// TapeGaugeScene::createScene
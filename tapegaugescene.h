@@ -0,0 +1,65 @@
+#ifndef TAPEGAUGESCENE_H
+#define TAPEGAUGESCENE_H
+
+#include "lineargaugescene.h"
+#include <QGraphicsRectItem>
+
+/*!
+ * \brief The TapeGaugeScene class displays a vertical tape, like an altitude
+ * or airspeed tape, that scrolls past a fixed pointer and readout box.
+ *
+ * The tape is built when the scene is created, using the tick mark builders
+ * of LinearGaugeScene and a label at every major tick. It is a layer inside a
+ * clip window that shows the visible range of the scale, centered on the
+ * reading. A new reading only moves the layer. For a scale that wraps around,
+ * like a heading, the tape is built three periods long, and the reading is
+ * moved into the middle period. A scale that would make a tape more than a few
+ * dozen windows long is built as a segment of a few windows around the
+ * reading instead, and the segment is built again when the reading nears one
+ * of its ends, so the tape never grows with the range of the scale.
+ */
+class TapeGaugeScene : public LinearGaugeScene
+{
+public:
+    TapeGaugeScene();
+
+    //! \return the range of the scale visible in the window, 0 for all of it
+    double getVisibleRange(void) const {return visibleRange;}
+
+    //! \return true if the scale wraps around from the top back to the start
+    bool getWrapping(void) const {return wrapping;}
+
+    //! Set the range of the scale visible in the window, 0 for all of it
+    void setVisibleRange(double range);
+
+    //! Set if the scale wraps around from the top back to the start
+    void setWrapping(bool wrap);
+
+protected: // methods
+    virtual void createScene(QGraphicsScene& scene) override;
+    virtual void updateReading(QGraphicsScene& scene) override;
+
+    void fillTape(double center);
+    void buildTape(QGraphicsScene& scene, double center);
+    void buildTapeLabels(QGraphicsScene& scene, double realStart, double period);
+    void buildReadout(QGraphicsScene& scene);
+    double tapeReading(void) const;
+    void moveTape(void);
+
+    //! \return the range the number of tick marks is limited over, which is fixed for a segment so every segment has the same ticks
+    virtual double tickRange(void) const override;
+
+protected: // properties
+    double visibleRange;            //!< Range of the scale visible in the window, 0 for all of it
+    bool wrapping;                  //!< True if the scale wraps around from the top back to the start
+    double pixelsPerUnit;           //!< Pixels of tape per unit of the scale
+    double tapeStart;               //!< Scale value at the bottom of the tape
+    double tapeLength;              //!< Length of the tape in pixels
+    double tapeEnd;                 //!< Scale value at the top of the tape
+    double windowRange;             //!< Range of the scale seen in the window
+    bool windowed;                  //!< True if the tape is a segment around the reading, built again as the reading moves
+    QGraphicsRectItem* clipItem;    //!< The window that the tape is seen through
+    QGraphicsRectItem* tapeLayer;   //!< Parent of the ticks and labels of the tape, moved for each reading
+};
+
+#endif // TAPEGAUGESCENE_H
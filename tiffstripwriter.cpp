@@ -0,0 +1,213 @@
+#include "tiffstripwriter.h"
+#include <QByteArray>
+#include <vector>
+
+//! Append a 16-bit little endian value to a buffer
+static void appendShort(QByteArray & buffer, uint16_t value)
+{
+    buffer.append((char)(value & 0xFF));
+    buffer.append((char)(value >> 8));
+}
+
+
+//! Append a 32-bit little endian value to a buffer
+static void appendLong(QByteArray & buffer, uint32_t value)
+{
+    appendShort(buffer, (uint16_t)(value & 0xFFFF));
+    appendShort(buffer, (uint16_t)(value >> 16));
+}
+
+
+/*!
+ * Append one 12 byte entry of the image file directory to a buffer
+ * \param buffer receives the entry
+ * \param tag is the TIFF tag of the entry
+ * \param type is 3 for SHORT, 4 for LONG, or 5 for RATIONAL
+ * \param count is the number of values
+ * \param value is the value itself if it fits in 4 bytes, else the offset of the values
+ */
+static void appendEntry(QByteArray & buffer, uint16_t tag, uint16_t type, uint32_t count, uint32_t value)
+{
+    appendShort(buffer, tag);
+    appendShort(buffer, type);
+    appendLong(buffer, count);
+
+    // A single SHORT sits in the first two bytes of the value
+    if((type == 3) && (count == 1))
+    {
+        appendShort(buffer, (uint16_t)value);
+        appendShort(buffer, 0);
+    }
+    else
+        appendLong(buffer, value);
+}
+
+
+TiffStripWriter::TiffStripWriter() :
+    width(0),
+    height(0),
+    rowsPerStrip(0),
+    written(0)
+{
+}
+
+
+TiffStripWriter::~TiffStripWriter()
+{
+    close();
+}
+
+
+/*!
+ * Create the file and write the header, the image file directory, and the
+ * table of strip offsets and sizes. The image is baseline RGB with 8 bits per
+ * sample and no compression.
+ * \param fileName is the name of the file to create
+ * \param imageWidth is the width of the image in pixels
+ * \param imageHeight is the height of the image in pixels
+ * \param stripRows is the number of rows in every strip but the last
+ * \return true if the file was created, false if it could not be opened or
+ *         the image is too large for a classic TIFF file
+ */
+bool TiffStripWriter::open(const QString & fileName, int imageWidth, int imageHeight, int stripRows)
+{
+    close();
+
+    if((imageWidth <= 0) || (imageHeight <= 0) || (stripRows <= 0))
+        return false;
+
+    width = imageWidth;
+    height = imageHeight;
+    rowsPerStrip = (stripRows < height) ? stripRows : height;
+    written = 0;
+
+    const int count = strips();
+    const uint32_t entries = 13;
+    const uint64_t rowBytes = (uint64_t)width*3;
+
+    // Everything before the pixels: header, directory, then the values that do not fit in the directory
+    const uint32_t directory = 8;
+    const uint32_t bitsPerSample = directory + 2 + entries*12 + 4;
+    const uint32_t xResolution = bitsPerSample + 6;
+    const uint32_t yResolution = xResolution + 8;
+    const uint32_t stripOffsets = yResolution + 8;
+    const uint32_t stripByteCounts = stripOffsets + 4*count;
+    const uint64_t pixels = (uint64_t)stripByteCounts + 4*count;
+
+    // Classic TIFF uses 32-bit offsets
+    if(pixels + rowBytes*height > 0xFFFFFFFFULL)
+        return false;
+
+    QByteArray header;
+    header.append("II");
+    appendShort(header, 42);
+    appendLong(header, directory);
+
+    appendShort(header, (uint16_t)entries);
+    appendEntry(header, 256, 4, 1, (uint32_t)width);            // ImageWidth
+    appendEntry(header, 257, 4, 1, (uint32_t)height);           // ImageLength
+    appendEntry(header, 258, 3, 3, bitsPerSample);              // BitsPerSample
+    appendEntry(header, 259, 3, 1, 1);                          // Compression, none
+    appendEntry(header, 262, 3, 1, 2);                          // PhotometricInterpretation, RGB
+    appendEntry(header, 273, 4, count, (count == 1) ? (uint32_t)pixels : stripOffsets);
+    appendEntry(header, 277, 3, 1, 3);                          // SamplesPerPixel
+    appendEntry(header, 278, 4, 1, (uint32_t)rowsPerStrip);     // RowsPerStrip
+    appendEntry(header, 279, 4, count, (count == 1) ? (uint32_t)(rowBytes*height) : stripByteCounts);
+    appendEntry(header, 282, 5, 1, xResolution);                // XResolution
+    appendEntry(header, 283, 5, 1, yResolution);                // YResolution
+    appendEntry(header, 284, 3, 1, 1);                          // PlanarConfiguration, chunky
+    appendEntry(header, 296, 3, 1, 2);                          // ResolutionUnit, inch
+    appendLong(header, 0);                                      // No more directories
+
+    for(int i = 0; i < 3; i++)
+        appendShort(header, 8);
+
+    // 72 pixels per inch
+    appendLong(header, 72);
+    appendLong(header, 1);
+    appendLong(header, 72);
+    appendLong(header, 1);
+
+    // Uncompressed, so every strip is known before any is drawn
+    for(int i = 0; i < count; i++)
+        appendLong(header, (uint32_t)(pixels + rowBytes*rowsPerStrip*i));
+
+    for(int i = 0; i < count; i++)
+    {
+        int rows = height - i*rowsPerStrip;
+        if(rows > rowsPerStrip)
+            rows = rowsPerStrip;
+        appendLong(header, (uint32_t)(rowBytes*rows));
+    }
+
+    file.setFileName(fileName);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    if(file.write(header) != header.size())
+    {
+        file.close();
+        return false;
+    }
+
+    return true;
+
+}// TiffStripWriter::open
+
+
+/*!
+ * Write the next strip of the image. The strips must be written in order from
+ * the top of the image down.
+ * \param strip is the strip, which must be as wide as the image and as tall as
+ *        the strip. Any alpha is dropped.
+ * \return true if the strip was written
+ */
+bool TiffStripWriter::writeStrip(const QImage & strip)
+{
+    if(!file.isOpen() || (written >= strips()))
+        return false;
+
+    int rows = height - written*rowsPerStrip;
+    if(rows > rowsPerStrip)
+        rows = rowsPerStrip;
+
+    if((strip.width() != width) || (strip.height() != rows))
+        return false;
+
+    QImage rgb = strip.convertToFormat(QImage::Format_RGB32);
+
+    // Pack each row to 3 bytes per pixel, one row at a time
+    std::vector<char> row((size_t)width*3);
+    for(int y = 0; y < rows; y++)
+    {
+        const QRgb* line = reinterpret_cast<const QRgb*>(rgb.constScanLine(y));
+        char* out = row.data();
+        for(int x = 0; x < width; x++)
+        {
+            *out++ = (char)qRed(line[x]);
+            *out++ = (char)qGreen(line[x]);
+            *out++ = (char)qBlue(line[x]);
+        }
+
+        if(file.write(row.data(), (qint64)row.size()) != (qint64)row.size())
+            return false;
+    }
+
+    written++;
+    return true;
+
+}// TiffStripWriter::writeStrip
+
+
+/*!
+ * Finish writing the file
+ * \return true if every strip of the image was written
+ */
+bool TiffStripWriter::close(void)
+{
+    if(!file.isOpen())
+        return false;
+
+    file.close();
+    return (written == strips()) && (file.error() == QFileDevice::NoError);
+}
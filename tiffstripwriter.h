@@ -0,0 +1,45 @@
+#ifndef TIFFSTRIPWRITER_H
+#define TIFFSTRIPWRITER_H
+
+#include <QFile>
+#include <QImage>
+#include <QString>
+#include <stdint.h>
+
+/*!
+ * \brief The TiffStripWriter class streams an uncompressed RGB TIFF file to
+ * disk one strip of rows at a time.
+ *
+ * Because the strips are not compressed their sizes are known up front, so
+ * the header and the strip table are written first and each strip can go
+ * straight to disk as soon as it is ready. Only one strip has to be in memory
+ * at a time, no matter how large the image is.
+ */
+class TiffStripWriter
+{
+public:
+    TiffStripWriter();
+
+    ~TiffStripWriter();
+
+    //! Create the file and write the header
+    bool open(const QString & fileName, int width, int height, int rowsPerStrip);
+
+    //! Write the next strip of the image
+    bool writeStrip(const QImage & strip);
+
+    //! Finish writing the file
+    bool close(void);
+
+    //! \return the number of strips in the image
+    int strips(void) const {return (rowsPerStrip > 0) ? (height + rowsPerStrip - 1)/rowsPerStrip : 0;}
+
+protected:
+    QFile file;             //!< The file being written
+    int width;              //!< Width of the image in pixels
+    int height;             //!< Height of the image in pixels
+    int rowsPerStrip;       //!< Number of rows in every strip but the last
+    int written;            //!< Number of strips written so far
+};
+
+#endif // TIFFSTRIPWRITER_H
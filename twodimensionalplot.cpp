@@ -1,16 +1,276 @@
 #include "twodimensionalplot.h"
+#include "colormap.h"
+#include "curveitem.h"
+#include "plothover.h"
+#include "scatteritem.h"
 #include <QGraphicsTextItem>
+#include <QtConcurrent>
+#include <QThread>
+#include <QPair>
+#include <QFuture>
+#include <QGraphicsRectItem>
+#include <QGraphicsPixmapItem>
+#include <math.h>
+
+/*!
+ * Copy the data and description of another plot data.  The pyramid is only
+ * copied if it is finished, so this is safe while the other pyramid is being
+ * built in the background.
+ * \param other is the plot data to copy
+ */
+plotData::plotData(const plotData & other) :
+    data(other.data),
+    color(other.color),
+    title(other.title),
+    scaler(other.scaler),
+    includeZero(other.includeZero),
+    drawAxis(other.drawAxis),
+    drawFirstLabel(other.drawFirstLabel),
+    labelsHigh(other.labelsHigh),
+    scatter(other.scatter),
+    markerSize(other.markerSize),
+    density(other.density),
+    declaredIncreasing(other.declaredIncreasing),
+    detectedIncreasing(other.detectedIncreasing),
+    detectedSamples(other.detectedSamples),
+    detectedScaler(other.detectedScaler)
+{
+    if(other.hasPyramid())
+        pyramid = other.pyramid;
+}
+
+
+/*!
+ * Copy the data and description of another plot data.  The pyramid is only
+ * copied if it is finished, so this is safe while the other pyramid is being
+ * built in the background.
+ * \param other is the plot data to copy
+ * \return a reference to this plot data
+ */
+plotData & plotData::operator=(const plotData & other)
+{
+    if(this == &other)
+        return *this;
+
+    // Our own pyramid is about to be replaced
+    pyramidBuild.waitForFinished();
+
+    data = other.data;
+    color = other.color;
+    title = other.title;
+    scaler = other.scaler;
+    includeZero = other.includeZero;
+    drawAxis = other.drawAxis;
+    drawFirstLabel = other.drawFirstLabel;
+    labelsHigh = other.labelsHigh;
+    scatter = other.scatter;
+    markerSize = other.markerSize;
+    density = other.density;
+    declaredIncreasing = other.declaredIncreasing;
+    detectedIncreasing = other.detectedIncreasing;
+    detectedSamples = other.detectedSamples;
+    detectedScaler = other.detectedScaler;
+
+    if(other.hasPyramid())
+        pyramid = other.pyramid;
+    else
+        pyramid.clear();
+
+    return *this;
+
+}// plotData::operator=
+
+
+/*!
+ * Build the min/max pyramid of the scaled data on this thread.  The pyramid
+ * must be rebuilt if the data or scaler change.
+ */
+void plotData::buildPyramid(void)
+{
+    pyramidBuild.waitForFinished();
+    pyramid.build(data, scaler);
+}
+
+
+/*!
+ * Build the min/max pyramid of the scaled data on the thread pool.  Plots
+ * generated before the build finishes simply draw every sample.  The data and
+ * scaler must not change while the build is running.
+ */
+void plotData::buildPyramidInBackground(void)
+{
+    pyramidBuild.waitForFinished();
+    pyramidBuild = QtConcurrent::run([this]() {pyramid.build(data, scaler);});
+}
+
+
+/*!
+ * Forget the pyramid and the detection of increasing data.  Changes to the
+ * number of samples or the scaler are noticed without this, but editing the
+ * values of the data in place is not, so call this after doing that.  A
+ * declaration from setIncreasing() is kept.
+ */
+void plotData::dataChanged(void)
+{
+    pyramidBuild.waitForFinished();
+    pyramid.clear();
+    detectedIncreasing = -1;
+}
+
+
+/*!
+ * Determine if the min/max pyramid can be used
+ * \return true if the pyramid is finished and was built from this data and scaler
+ */
+bool plotData::hasPyramid(void) const
+{
+    return pyramidBuild.isFinished() && !pyramid.isEmpty() && (pyramid.samples() == data.size()) && (pyramid.scaler() == scaler);
+}
+
+
+/*!
+ * Determine if the scaled data never decreases.  A declaration from
+ * setIncreasing() is used as is, otherwise the data are checked once and the
+ * answer is remembered until the number of samples or the scaler changes, or
+ * dataChanged() is called.  The detection writes to the cache, so call this
+ * on the thread that owns the data.
+ * \return true if the scaled data never decreases
+ */
+bool plotData::isIncreasing(void) const
+{
+    if(declaredIncreasing >= 0)
+        return (declaredIncreasing != 0);
+
+    if((detectedIncreasing >= 0) && (detectedSamples == data.size()) && (detectedScaler == scaler))
+        return (detectedIncreasing != 0);
+
+    bool increasing;
+    if(hasPyramid())
+        increasing = pyramid.isIncreasing();
+    else
+    {
+        increasing = true;
+        for(size_t i = 1; i < data.size(); i++)
+        {
+            if(data[i]*scaler < data[i-1]*scaler)
+            {
+                increasing = false;
+                break;
+            }
+        }
+    }
+
+    detectedIncreasing = increasing ? 1 : 0;
+    detectedSamples = data.size();
+    detectedScaler = scaler;
+
+    return increasing;
+
+}// plotData::isIncreasing
+
+
+/*!
+ * Copy the data of a plot, so it can be built on a worker thread while the
+ * caller changes the original data.
+ * \param xData is the x axis independent variable data
+ * \param yData is one or more y axis dependent variable data
+ * \param rData is one or more r axis (right vertical) dependent variable data
+ */
+plotSnapshot::plotSnapshot(const plotData * xData, const plotSet & yData, const plotSet & rData) :
+    x(*xData)
+{
+    // Reserve first, so the pointers into the vectors stay valid
+    y.reserve(yData.size());
+    r.reserve(rData.size());
+
+    for(size_t j = 0; j < yData.size(); j++)
+    {
+        y.push_back(*yData[j]);
+        ySet.push_back(&y.back());
+    }
+
+    for(size_t j = 0; j < rData.size(); j++)
+    {
+        r.push_back(*rData[j]);
+        rSet.push_back(&r.back());
+    }
+
+}// plotSnapshot::plotSnapshot
+
 
 TwoDimensionalPlot::TwoDimensionalPlot() :
-    TwoDimensionalScene()
+    TwoDimensionalScene(),
+    xRangeSet(false),
+    xRangeMin(0.0),
+    xRangeMax(1.0),
+    hoverReadout(false),
+    axisLayer(0),
+    axisClears(0),
+    layoutWatcher(0)
 {
 }
 
 
-//! Make sure everything that was drawn is in view
+TwoDimensionalPlot::~TwoDimensionalPlot()
+{
+    // The worker only uses its own copy of the data, so it can be left to finish
+    dropPendingPlot();
+    delete layoutWatcher;
+}
+
+
+/*!
+ * Set the range of the x axis, which is used to zoom and pan the plot.  The
+ * curves are clipped to the grid.  Call generatePlot() to show the change.
+ * \param minValue is the smallest x value to show
+ * \param maxValue is the largest x value to show
+ */
+void TwoDimensionalPlot::setXRange(double minValue, double maxValue)
+{
+    if(minValue < maxValue)
+    {
+        xRangeMin = minValue;
+        xRangeMax = maxValue;
+    }
+    else
+    {
+        xRangeMin = maxValue;
+        xRangeMax = minValue;
+    }
+
+    xRangeSet = (xRangeMin < xRangeMax);
+}
+
+
+/*!
+ * Fit the x axis to the range of the x data.  Call generatePlot() to show the change.
+ */
+void TwoDimensionalPlot::clearXRange(void)
+{
+    xRangeSet = false;
+}
+
+
+/*!
+ * Scale and center all the views of the scene so everything that was drawn
+ * is in view.  The drawn bounds are tracked as the plot is built, rather than
+ * asking the scene, which would compute the bounds of every curve path.
+ */
 void TwoDimensionalPlot::fitAllInView(void)
 {
-    QRectF sceneRect = myScene.itemsBoundingRect();
+    fitAllInView(getDrawnBounds());
+}
+
+
+/*!
+ * Scale and center all the views of the scene so a region is in view
+ * \param sceneRect is the region of the scene that must be visible
+ */
+void TwoDimensionalPlot::fitAllInView(const QRectF & sceneRect)
+{
+    // Nothing drawn yet
+    if((sceneRect.width() <= 0) || (sceneRect.height() <= 0))
+        return;
 
     // Make sure it is all visible
     foreach(QGraphicsView* view, myScene.views())
@@ -27,219 +287,1176 @@ void TwoDimensionalPlot::fitAllInView(void)
         double horscaler = viewRect.width()/sceneRect.width();
         double verscaler = viewRect.height()/sceneRect.height();
 
-        // Make it big enough to fit
-        if(horscaler > verscaler)
-            view->scale(verscaler, verscaler);
-        else
-            view->scale(horscaler, horscaler);
+        // Make it big enough to fit
+        if(horscaler > verscaler)
+            view->scale(verscaler, verscaler);
+        else
+            view->scale(horscaler, horscaler);
+
+        view->centerOn(0.5*(sceneRect.right()+sceneRect.left()), 0.5*(sceneRect.top()+sceneRect.bottom()));
+
+
+        // view->fitInView(sceneRect, Qt::KeepAspectRatio);
+    }
+}
+
+
+/*!
+ * Generate a two dimensional plot of data with multiple dependent variables on
+ * the left and right vertical axis. This version fills the entire scene, clearing
+ * any data that was already there
+ * \param title is the plot title
+ * \param xTicks is the approximate number of desired tick marks in the x axis
+ * \param yTicks is the approximate number of desired tick marks in the y axis
+ * \param xData is the x axis independent variable data
+ * \param yData is one or more y axis dependent variable data
+ * \param rData is one or more r axis (right vertical) dependent variable data
+ * \param yScaleEqualsxScale should be true to force the y scale to match the x
+ *        scale, which is useful for things that have physical shape.
+ * \param rScaleEqualsxScale should be true to force the r scale to match the x
+ *        scale, which is useful for things that have physical shape.
+ * \param aspectRatio is used to control the aspect ratio (ratio of width to
+ *        height). Pass 0 or negative to allow the aspect ratio to float
+ */
+void TwoDimensionalPlot::generatePlot(const QString & title, uint32_t xTicks, uint32_t yTicks, const plotData * xData, const plotSet & yData, const plotSet & rData, bool yScaleEqualsxScale, bool rScaleEqualsxScale, double aspectRatio)
+{
+    // An asynchronous plot that is still being computed is now out of date
+    dropPendingPlot();
+
+    // The grid, axes, and title are kept if they come out the same
+    clearExceptAxes();
+
+    drawLayout(layoutPlot(title, size, xTicks, yTicks, xData, yData, rData, yScaleEqualsxScale, rScaleEqualsxScale, aspectRatio), true);
+
+    fitAllInView();
+
+}// TwoDimensionalPlot::generatePlot
+
+
+/*!
+ * Generate a two dimensional plot of data with multiple dependent variables on
+ * the left and right vertical axis
+ * \param title is the plot title
+ * \param region is the scene/view region over which the plot should be generated
+ * \param xTicks is the approximate number of desired tick marks in the x axis
+ * \param yTicks is the approximate number of desired tick marks in the y axis
+ * \param xData is the x axis independent variable data
+ * \param yData is one or more y axis dependent variable data
+ * \param rData is one or more r axis (right vertical) dependent variable data
+ * \param yScaleEqualsxScale should be true to force the y scale to match the x
+ *        scale, which is useful for things that have physical shape.
+ * \param rScaleEqualsxScale should be true to force the r scale to match the x
+ *        scale, which is useful for things that have physical shape.
+ * \param aspectRatio is used to control the aspect ratio (ratio of width to
+ *        height). Pass 0 or negative to allow the aspect ratio to float
+ */
+void TwoDimensionalPlot::generatePlot(const QString & title, QRectF region, uint32_t xTicks, uint32_t yTicks, const plotData * xData, const plotSet & yData, const plotSet & rData, bool yScaleEqualsxScale, bool rScaleEqualsxScale, double aspectRatio)
+{
+    drawLayout(layoutPlot(title, region, xTicks, yTicks, xData, yData, rData, yScaleEqualsxScale, rScaleEqualsxScale, aspectRatio));
+
+}// TwoDimensionalPlot::generatePlot
+
+
+/*!
+ * Compute the layout of a plot on this thread, using the x range of the plot
+ * and adding the hover readout if it is enabled.
+ * \param title is the plot title
+ * \param region is the scene/view region over which the plot should be generated
+ * \param xTicks is the approximate number of desired tick marks in the x axis
+ * \param yTicks is the approximate number of desired tick marks in the y axis
+ * \param xData is the x axis independent variable data
+ * \param yData is one or more y axis dependent variable data
+ * \param rData is one or more r axis (right vertical) dependent variable data
+ * \param yScaleEqualsxScale should be true to force the y scale to match the x scale
+ * \param rScaleEqualsxScale should be true to force the r scale to match the x scale
+ * \param aspectRatio is the ratio of width to height, 0 or negative to float
+ * \return the layout of the plot
+ */
+plotLayout TwoDimensionalPlot::layoutPlot(const QString & title, QRectF region, uint32_t xTicks, uint32_t yTicks, const plotData * xData, const plotSet & yData, const plotSet & rData, bool yScaleEqualsxScale, bool rScaleEqualsxScale, double aspectRatio) const
+{
+    if(hoverReadout)
+    {
+        // The hover readout outlives this call, so it needs its own copy of the data
+        std::shared_ptr<plotSnapshot> snapshot = std::make_shared<plotSnapshot>(xData, yData, rData);
+        return computeLayout(title, region, xTicks, yTicks, &snapshot->x, snapshot->ySet, snapshot->rSet, yScaleEqualsxScale, rScaleEqualsxScale, aspectRatio, xRangeSet, xRangeMin, xRangeMax, snapshot);
+    }
+    else
+        return computeLayout(title, region, xTicks, yTicks, xData, yData, rData, yScaleEqualsxScale, rScaleEqualsxScale, aspectRatio, xRangeSet, xRangeMin, xRangeMax, std::shared_ptr<const plotSnapshot>());
+
+}// TwoDimensionalPlot::layoutPlot
+
+
+/*!
+ * Generate a two dimensional plot that fills the entire scene, like
+ * generatePlot(), but do the data work on the thread pool.  Every channel is
+ * deep copied first, on the calling thread, so the caller is free to change
+ * the data as soon as this returns; the copy is O(samples) of GUI thread time
+ * and memory.  The old plot stays in the scene until the new one is ready,
+ * then the scene is replaced in one step on this thread.  If another plot is
+ * requested before this one is ready, this one is dropped.  This must be
+ * called from the GUI thread, which must run an event loop.
+ * \param title is the plot title
+ * \param xTicks is the approximate number of desired tick marks in the x axis
+ * \param yTicks is the approximate number of desired tick marks in the y axis
+ * \param xData is the x axis independent variable data
+ * \param yData is one or more y axis dependent variable data
+ * \param rData is one or more r axis (right vertical) dependent variable data
+ * \param yScaleEqualsxScale should be true to force the y scale to match the x
+ *        scale, which is useful for things that have physical shape.
+ * \param rScaleEqualsxScale should be true to force the r scale to match the x
+ *        scale, which is useful for things that have physical shape.
+ * \param aspectRatio is used to control the aspect ratio (ratio of width to
+ *        height). Pass 0 or negative to allow the aspect ratio to float
+ * \param drawn is called on this thread once the new plot is in the scene, it
+ *        is never called if the plot is dropped
+ * \return the future of the work on the thread pool, which finishes when the
+ *         plot is computed, before it is put in the scene
+ */
+QFuture<void> TwoDimensionalPlot::generatePlotAsync(const QString & title, uint32_t xTicks, uint32_t yTicks, const plotData * xData, const plotSet & yData, const plotSet & rData, bool yScaleEqualsxScale, bool rScaleEqualsxScale, double aspectRatio, std::function<void(void)> drawn)
+{
+    // Copy the data, the worker thread never touches the caller's data
+    std::shared_ptr<plotSnapshot> snapshot = std::make_shared<plotSnapshot>(xData, yData, rData);
+
+    // Anything still in flight is now out of date
+    dropPendingPlot();
+
+    plotDrawn = drawn;
+
+    QRectF region = size;
+    bool zoomed = xRangeSet;
+    double zoomMin = xRangeMin;
+    double zoomMax = xRangeMax;
+    std::shared_ptr<const plotSnapshot> hoverData;
+    if(hoverReadout)
+        hoverData = snapshot;
+
+    QFuture<plotLayout> future = QtConcurrent::run([=]()
+    {
+        return computeLayout(title, region, xTicks, yTicks, &snapshot->x, snapshot->ySet, snapshot->rSet, yScaleEqualsxScale, rScaleEqualsxScale, aspectRatio, zoomed, zoomMin, zoomMax, hoverData);
+    });
+
+    // The watcher only reports the future it is watching, so an older plot
+    //   that finishes late is never drawn
+    if(layoutWatcher == 0)
+    {
+        layoutWatcher = new QFutureWatcher<plotLayout>();
+        QObject::connect(layoutWatcher, &QFutureWatcher<plotLayout>::finished, [this]() {swapInLayout();});
+    }
+
+    layoutWatcher->setFuture(future);
+
+    return QFuture<void>(future);
+
+}// TwoDimensionalPlot::generatePlotAsync
+
+
+/*!
+ * Replace the contents of the scene with the plot computed by
+ * generatePlotAsync(), and call back to report the plot is drawn.
+ */
+void TwoDimensionalPlot::swapInLayout(void)
+{
+    if(layoutWatcher->future().isCanceled())
+        return;
+
+    clearExceptAxes();
+    drawLayout(layoutWatcher->future().result(), true);
+    fitAllInView();
+
+    // The callback may request another plot, which replaces plotDrawn
+    std::function<void(void)> drawn = plotDrawn;
+    plotDrawn = std::function<void(void)>();
+    if(drawn)
+        drawn();
+
+}// TwoDimensionalPlot::swapInLayout
+
+
+//! Drop the plot from generatePlotAsync() that is in flight, if any, so it is never drawn
+void TwoDimensionalPlot::dropPendingPlot(void)
+{
+    // Stop watching, a default future is canceled so it is never drawn
+    if(layoutWatcher)
+        layoutWatcher->setFuture(QFuture<plotLayout>());
+
+    plotDrawn = std::function<void(void)>();
+}
+
+
+/*!
+ * Compute everything about a plot that depends on the data: ranges, tick
+ * marks, scaling, and the geometry of every curve.  This only reads the data
+ * and does not touch the scene, so it can be run on a worker thread.  The
+ * caches of the data may be written, so the data must not be shared with
+ * another thread.
+ * \param title is the plot title
+ * \param region is the scene/view region over which the plot should be generated
+ * \param xTicks is the approximate number of desired tick marks in the x axis
+ * \param yTicks is the approximate number of desired tick marks in the y axis
+ * \param xData is the x axis independent variable data
+ * \param yData is one or more y axis dependent variable data
+ * \param rData is one or more r axis (right vertical) dependent variable data
+ * \param yScaleEqualsxScale should be true to force the y scale to match the x scale
+ * \param rScaleEqualsxScale should be true to force the r scale to match the x scale
+ * \param aspectRatio is the ratio of width to height, 0 or negative to float
+ * \param zoomed is true if the x axis range is set rather than fit to the data
+ * \param zoomMin is the smallest x value to show when zoomed
+ * \param zoomMax is the largest x value to show when zoomed
+ * \param hoverData is the snapshot that xData, yData, and rData point into, if
+ *        the plot has a hover readout, else null
+ * \return the layout of the plot, which is drawn with drawLayout()
+ */
+plotLayout TwoDimensionalPlot::computeLayout(const QString & title, QRectF region, uint32_t xTicks, uint32_t yTicks, const plotData * xData, const plotSet & yData, const plotSet & rData, bool yScaleEqualsxScale, bool rScaleEqualsxScale, double aspectRatio, bool zoomed, double zoomMin, double zoomMax, std::shared_ptr<const plotSnapshot> hoverData)
+{
+    plotLayout layout;
+
+    layout.title = title;
+    layout.region = region;
+
+    // Origin of the grid in pixels
+    layout.yOrg = region.bottom();
+    layout.xOrg = region.left();
+
+    // Tick mark spacing details for the X axis
+    layout.numXticks = xTicks;
+    if(zoomed)
+        layout.xdigits = TwoDimensionalScene::tickMarks(zoomMin, zoomMax, &layout.numXticks, &layout.xMin, &layout.xMax);
+    else
+        layout.xdigits = tickMarks(xData, &layout.numXticks, &layout.xMin, &layout.xMax);
+
+    // When zoomed on increasing x only the visible slice of the data matters,
+    //   plus one sample on each side so the curves run to the edge of the grid
+    plotSlice slice;
+    slice.increasing = xData->isIncreasing();
+    if(zoomed && slice.increasing)
+        visibleSamples(xData, layout.xMin, layout.xMax, &slice.first, &slice.last);
+
+    // Tick mark spacing details for the Y axis
+    layout.numYticks = yTicks;
+    layout.ydigits = tickMarks(yData, slice.first, slice.last, &layout.numYticks, &layout.yMin, &layout.yMax);
+
+    // Tick mark spacing details for the R axis
+    layout.numRticks = yTicks;
+    layout.rdigits = tickMarks(rData, slice.first, slice.last, &layout.numRticks, &layout.rMin, &layout.rMax);
+
+    // Now we have to decide whose tick marks to go with, the y or r axis.
+    //   Choose the larger of the two tick marks values, and then re-run the
+    //   other axis spacing, with a fixed number of tick marks
+    if(layout.numYticks > layout.numRticks)
+    {
+        layout.numRticks = layout.numYticks;
+        layout.rdigits = tickMarks(rData, slice.first, slice.last, layout.numRticks, &layout.rMin, &layout.rMax);
+    }
+    else if(layout.numRticks > layout.numYticks)
+    {
+        layout.numYticks = layout.numRticks;
+        layout.ydigits = tickMarks(yData, slice.first, slice.last, layout.numYticks, &layout.yMin, &layout.yMax);
+    }
+
+    double width = region.width();
+    double height = region.height();
+
+    // Does caller want to control the aspect ratio?
+    if(aspectRatio > 0)
+    {
+        if(height*aspectRatio > width)
+            height = width/aspectRatio;
+        else
+            width = height*aspectRatio;
+    }
+
+    // Figure out graph scaling, remember top - bottom is a negative number
+    layout.xScale = width/(layout.xMax - layout.xMin);
+    layout.yScale = height/(layout.yMin - layout.yMax);
+    layout.rScale = height/(layout.rMin - layout.rMax);
+
+    // For controlling plot distortion, remember that vertical dimensions have reversed sign
+    if(yScaleEqualsxScale)
+        layout.yScale = -layout.xScale;
+    if(rScaleEqualsxScale)
+        layout.rScale = -layout.xScale;
+
+    // Everything the axes need from the data
+    layout.xTitle = xData->title;
+    layout.xColor = xData->color;
+    layout.xDrawAxis = xData->drawAxis;
+    layout.xLabelsHigh = xData->labelsHigh;
+
+    layout.yAxis = (yData.size() > 0);
+    if(layout.yAxis)
+    {
+        layout.yLabels = labelsFromPlotSet(yData);
+        layout.yColors = colorsFromPlotSet(yData);
+        layout.yLeft = !yData.at(0)->labelsHigh;
+        layout.yFirstLabel = drawFirstLabelFromPlotSet(yData);
+    }
+
+    layout.rAxis = (rData.size() > 0);
+    if(layout.rAxis)
+    {
+        layout.rLabels = labelsFromPlotSet(rData);
+        layout.rColors = colorsFromPlotSet(rData);
+        layout.rLeft = rData.at(0)->labelsHigh;
+        layout.rFirstLabel = drawFirstLabelFromPlotSet(rData);
+    }
+
+    // When zoomed the curves run past the grid, so they are clipped to it
+    layout.grid = QRectF(QPointF(layout.xOrg, layout.yOrg + layout.yScale*(layout.yMax - layout.yMin)), QPointF(layout.xOrg + layout.xScale*(layout.xMax - layout.xMin), layout.yOrg)).normalized();
+    layout.clip = zoomed;
+
+    plotMapping yMap(layout.xOrg, layout.yOrg, layout.xScale, layout.yScale, layout.xMin, layout.yMin);
+    plotMapping rMap(layout.xOrg, layout.yOrg, layout.xScale, layout.rScale, layout.xMin, layout.rMin);
+
+    // The data are inside the axis spans (or clipped to them), so the extent
+    //   of the curves is known without looking at their paths
+    if(layout.yAxis)
+        layout.curveBounds |= QRectF(QPointF(yMap.toX(layout.xMin), yMap.toY(layout.yMin)), QPointF(yMap.toX(layout.xMax), yMap.toY(layout.yMax))).normalized();
+    if(layout.rAxis)
+        layout.curveBounds |= QRectF(QPointF(rMap.toX(layout.xMin), rMap.toY(layout.rMin)), QPointF(rMap.toX(layout.xMax), rMap.toY(layout.rMax))).normalized();
+
+    // QVector is reentrant, so every curve is built on the thread pool. Only
+    //   putting the curves in the scene has to happen on the GUI thread.
+    QList< QFuture<plotCurve> > curves;
+
+    for(size_t j = 0; j < yData.size(); j++)
+        curves.append(QtConcurrent::run(&TwoDimensionalPlot::buildCurve, xData, yData[j], yMap, slice, layout.grid));
+
+    for(size_t j = 0; j < rData.size(); j++)
+        curves.append(QtConcurrent::run(&TwoDimensionalPlot::buildCurve, xData, rData[j], rMap, slice, layout.grid));
+
+    // The index for the hover readout is built once per plot, while the curves are built
+    if(hoverData)
+        layout.hover = std::make_shared<plotHoverIndex>(hoverData, yMap, rMap, slice, layout.grid);
+
+    // The curves are kept in the same order as the data, y then r
+    for(int j = 0; j < curves.size(); j++)
+        layout.curves.push_back(curves[j].result());
+
+    return layout;
+
+}// TwoDimensionalPlot::computeLayout
+
+
+/*!
+ * Draw a plot computed by computeLayout() into the scene.  This only creates
+ * items, all the data work was done by computeLayout().
+ * \param layout is the plot to draw
+ * \param reuseAxes should be true if this plot fills the scene.  The grid,
+ *        axes, and title are then drawn into a layer that is kept, and reused
+ *        by the next plot if they come out the same.  Use clearExceptAxes()
+ *        rather than clear() before drawing.
+ */
+void TwoDimensionalPlot::drawLayout(const plotLayout & layout, bool reuseAxes)
+{
+    if(!reuseAxes)
+        drawAxes(layout);
+    else if(hasAxisLayer() && axisKey.sameAxes(layout))
+        includeBounds(axisBounds);
+    else
+    {
+        if(hasAxisLayer())
+            delete axisLayer;
+
+        // Draw into a new layer, and remember what it covers
+        QRectF drawn = bounds;
+        bounds = QRectF();
+
+        axisLayer = myScene.addRect(QRectF(), QPen(Qt::NoPen));
+        setLayer(axisLayer);
+        drawAxes(layout);
+        setLayer(0);
+
+        axisBounds = bounds;
+        bounds = drawn | axisBounds;
+        axisClears = clears;
+
+        // Only the axes are needed to compare
+        axisKey = layout;
+        axisKey.curves.clear();
+        axisKey.hover.reset();
+    }
+
+    // When zoomed the curves run past the grid, so clip them to it
+    QGraphicsRectItem* clip = 0;
+    if(layout.clip)
+    {
+        clip = myScene.addRect(layout.grid, QPen(Qt::NoPen));
+        clip->setFlag(QGraphicsItem::ItemClipsChildrenToShape);
+    }
+
+    includeBounds(layout.curveBounds);
+
+    // Put the curves in the scene with the right color, in the same order as the data
+    for(size_t j = 0; j < layout.curves.size(); j++)
+        addCurve(layout.curves[j], clip);
+
+    // The hover readout sits above the curves, and only changes its own children
+    if(layout.hover)
+    {
+        PlotHoverItem* item = new PlotHoverItem(layout.hover);
+        item->setZValue(2.0);
+        myScene.addItem(item);
+    }
+
+}// TwoDimensionalPlot::drawLayout
+
+
+/*!
+ * Remove everything from the scene except the cached axis layer, so a new
+ * plot can reuse it.  If there is no axis layer this is the same as clear().
+ */
+void TwoDimensionalPlot::clearExceptAxes(void)
+{
+    if(!hasAxisLayer())
+    {
+        clear();
+        return;
+    }
+
+    // Deleting an item deletes its children, so only the top level items
+    QList<QGraphicsItem*> remove;
+    foreach(QGraphicsItem* item, myScene.items())
+    {
+        if((item->parentItem() == 0) && (item != axisLayer))
+            remove.append(item);
+    }
+
+    qDeleteAll(remove);
+
+    layer = 0;
+    bounds = QRectF();
+
+}// TwoDimensionalPlot::clearExceptAxes
+
+
+/*!
+ * Determine if the grid, axes, and title of another layout are drawn the
+ * same as this one.  The curves are not compared.
+ * \param other is the other layout
+ * \return true if the grid, axes, and title are the same
+ */
+bool plotLayout::sameAxes(const plotLayout & other) const
+{
+    return (title == other.title) && (region == other.region) &&
+           (xOrg == other.xOrg) && (yOrg == other.yOrg) &&
+           (xScale == other.xScale) && (yScale == other.yScale) && (rScale == other.rScale) &&
+           (xMin == other.xMin) && (xMax == other.xMax) &&
+           (yMin == other.yMin) && (yMax == other.yMax) &&
+           (rMin == other.rMin) && (rMax == other.rMax) &&
+           (numXticks == other.numXticks) && (numYticks == other.numYticks) && (numRticks == other.numRticks) &&
+           (xdigits == other.xdigits) && (ydigits == other.ydigits) && (rdigits == other.rdigits) &&
+           (xTitle == other.xTitle) && (xColor == other.xColor) &&
+           (xDrawAxis == other.xDrawAxis) && (xLabelsHigh == other.xLabelsHigh) &&
+           (yAxis == other.yAxis) && (yLabels == other.yLabels) && (yColors == other.yColors) &&
+           (yLeft == other.yLeft) && (yFirstLabel == other.yFirstLabel) &&
+           (rAxis == other.rAxis) && (rLabels == other.rLabels) && (rColors == other.rColors) &&
+           (rLeft == other.rLeft) && (rFirstLabel == other.rFirstLabel);
+
+}// plotLayout::sameAxes
+
+
+/*!
+ * Draw the grid, axes, and title of a plot computed by computeLayout()
+ * \param layout is the plot to draw
+ */
+void TwoDimensionalPlot::drawAxes(const plotLayout & layout)
+{
+    // Draw the grid lines
+    drawGrid(layout.xOrg, layout.yOrg, layout.xScale, layout.xMin, layout.xMax, layout.numXticks*2, layout.yScale, layout.yMin, layout.yMax, layout.numYticks*2);
+
+    // The X axis and its tick marks and labels
+    if(layout.xDrawAxis)
+        DrawHorizontalAxis(layout.xOrg, layout.yOrg, layout.xScale, layout.xMin, layout.xMax, layout.numXticks, layout.xTitle, layout.xdigits, layout.xColor, layout.xLabelsHigh);
+
+    // The left vertical (Y) axis and its tick marks and lables
+    if(layout.yAxis)
+        DrawVerticalAxis(layout.xOrg, layout.yOrg, layout.yScale, layout.yMin, layout.yMax, layout.numYticks, layout.yLabels, layout.ydigits, layout.yColors, layout.yLeft, layout.yFirstLabel);
+
+    // The right vertical (R) axis and its tick marks and lables
+    if(layout.rAxis)
+        DrawVerticalAxis(layout.region.right(), layout.yOrg, layout.rScale, layout.rMin, layout.rMax, layout.numRticks, layout.rLabels, layout.rdigits, layout.rColors, layout.rLeft, layout.rFirstLabel);
+
+    // Add the title to the plot
+    if(!layout.title.isEmpty())
+    {
+        QPointF pos;
+        QGraphicsTextItem* item = addText(layout.title);
+
+        // Title is centered at the top
+        pos.setY(layout.region.top());
+        pos.setX((layout.region.left()+layout.region.right())*0.5);
+        pos += rectOffsetForTopCenter(item->boundingRect());
+        placeText(item, pos);
+    }
+
+}// TwoDimensionalPlot::drawAxes
+
+
+/*!
+ * Find the largest count of any bin
+ * \return the largest count, 0 if there are no bins
+ */
+uint64_t plotHistogram::largest(void) const
+{
+    uint64_t most = 0;
+    for(size_t i = 0; i < counts.size(); i++)
+    {
+        if(counts[i] > most)
+            most = counts[i];
+    }
+
+    return most;
+}
+
+
+//! Fewest samples worth giving to a thread
+static const size_t minimumChunkSamples = 1 << 16;
+
+
+/*!
+ * Split a number of samples into chunks for the thread pool
+ * \param samples is the number of samples
+ * \return the number of chunks, at least one
+ */
+static size_t chunksForSamples(size_t samples)
+{
+    size_t chunks = samples/minimumChunkSamples;
+    size_t most = 4*(size_t)QThread::idealThreadCount();
+
+    if(chunks > most)
+        chunks = most;
+    if(chunks < 1)
+        chunks = 1;
+
+    return chunks;
+}
+
+
+/*!
+ * Find the range of a chunk of samples.  The loop has no branches, so the
+ * compiler can vectorize it.  NaN samples are ignored.
+ * \param data points to the first sample of the chunk
+ * \param count is the number of samples in the chunk
+ * \param scaler is multiplied by every sample
+ * \return the smallest and largest scaled sample, the smallest is larger
+ *         than the largest if there are no numbers in the chunk
+ */
+static QPair<double, double> chunkRange(const double* data, size_t count, double scaler)
+{
+    double low = std::numeric_limits<double>::infinity();
+    double high = -std::numeric_limits<double>::infinity();
+
+    for(size_t i = 0; i < count; i++)
+    {
+        double value = data[i]*scaler;
+        low = (value < low) ? value : low;
+        high = (value > high) ? value : high;
+    }
+
+    return qMakePair(low, high);
+}
+
+
+/*!
+ * Count a chunk of samples into bins.  Samples past either end are counted in
+ * the end bins, NaN samples are not counted.
+ * \param data points to the first sample of the chunk
+ * \param count is the number of samples in the chunk
+ * \param scaler is multiplied by every sample
+ * \param start is the low edge of the first bin
+ * \param width is the width of every bin
+ * \param bins is the number of bins
+ * \return the count of each bin, for this chunk only
+ */
+static std::vector<uint64_t> chunkCounts(const double* data, size_t count, double scaler, double start, double width, size_t bins)
+{
+    std::vector<uint64_t> counts(bins, 0);
+    double inverse = 1.0/width;
+    double top = (double)(bins - 1);
+
+    for(size_t i = 0; i < count; i++)
+    {
+        double bin = (data[i]*scaler - start)*inverse;
+
+        // This also rejects NaN
+        if(!(bin == bin))
+            continue;
+
+        bin = (bin < 0.0) ? 0.0 : bin;
+        bin = (bin > top) ? top : bin;
+        counts[(size_t)bin]++;
+    }
+
+    return counts;
+}
+
+
+/*!
+ * Get the range of the scaled data in a array.  If the data have a pyramid it
+ * is used, otherwise the data are split into chunks whose ranges are found in
+ * parallel on the thread pool, and then merged.
+ * \param axis is the data to find the range of
+ * \param minValue receives the smallest scaled value
+ * \param maxValue receives the largest scaled value
+ * \return true if the range was found, false if there are no numbers in the data
+ */
+bool TwoDimensionalPlot::parallelRange(const plotData * axis, double* minValue, double* maxValue)
+{
+    size_t samples = axis->data.size();
+    if(samples == 0)
+        return false;
+
+    if(axis->hasPyramid())
+    {
+        axis->pyramid.range(axis->data, axis->scaler, 0, samples - 1, minValue, maxValue);
+        return true;
+    }
+
+    size_t chunks = chunksForSamples(samples);
+    QList< QFuture< QPair<double, double> > > ranges;
+    for(size_t k = 0; k < chunks; k++)
+    {
+        size_t first = (samples*k)/chunks;
+        size_t last = (samples*(k+1))/chunks;
+        ranges.append(QtConcurrent::run(&chunkRange, axis->data.data() + first, last - first, axis->scaler));
+    }
+
+    // Merge the partial ranges
+    double low = std::numeric_limits<double>::infinity();
+    double high = -std::numeric_limits<double>::infinity();
+    for(int k = 0; k < ranges.size(); k++)
+    {
+        QPair<double, double> range = ranges[k].result();
+        if(range.first < low)
+            low = range.first;
+        if(range.second > high)
+            high = range.second;
+    }
+
+    if(!(low <= high))
+        return false;
+
+    *minValue = low;
+    *maxValue = high;
+    return true;
+
+}// TwoDimensionalPlot::parallelRange
 
-        view->centerOn(0.5*(sceneRect.right()+sceneRect.left()), 0.5*(sceneRect.top()+sceneRect.bottom()));
 
+/*!
+ * Count the scaled samples of one data in bins.  The bin edges come from the
+ * tick mark computation, so they fall on round numbers.  The data are split
+ * into chunks that are counted in parallel on the thread pool, each into its
+ * own partial histogram, and the partial histograms are added at the end.
+ * This only reads the data, so it can be run on a worker thread.
+ * \param data is the data to count
+ * \param bins is the approximate number of bins
+ * \param histogram receives the counts
+ * \return true if the histogram was computed, false if there is no data
+ */
+bool TwoDimensionalPlot::computeHistogram(const plotData * data, uint32_t bins, plotHistogram* histogram)
+{
+    double low, high;
+    if(!parallelRange(data, &low, &high))
+        return false;
+
+    if(data->includeZero)
+    {
+        if(low > 0.0)
+            low = 0.0;
+        if(high < 0.0)
+            high = 0.0;
+    }
 
-        // view->fitInView(sceneRect, Qt::KeepAspectRatio);
+    if(bins < 1)
+        bins = 1;
+
+    // The bins are the tick marks of an axis that spans the data
+    double end;
+    uint32_t numBins = bins;
+    histogram->digits = TwoDimensionalScene::tickMarks(low, high, &numBins, &histogram->start, &end);
+    if(numBins < 1)
+        numBins = 1;
+    histogram->width = (end - histogram->start)/numBins;
+    if(!(histogram->width > 0.0))
+        histogram->width = 1.0;
+
+    size_t samples = data->data.size();
+    size_t chunks = chunksForSamples(samples);
+    double scaler = data->scaler;
+    double start = histogram->start;
+    double width = histogram->width;
+    QList< QFuture< std::vector<uint64_t> > > partials;
+    for(size_t k = 0; k < chunks; k++)
+    {
+        const double* first = data->data.data() + (samples*k)/chunks;
+        size_t count = (samples*(k+1))/chunks - (samples*k)/chunks;
+        partials.append(QtConcurrent::run([=]() {return chunkCounts(first, count, scaler, start, width, numBins);}));
     }
-}
+
+    // Merge the partial histograms
+    histogram->counts.assign(numBins, 0);
+    histogram->total = 0;
+    for(int k = 0; k < partials.size(); k++)
+    {
+        std::vector<uint64_t> counts = partials[k].result();
+        for(size_t i = 0; i < counts.size(); i++)
+        {
+            histogram->counts[i] += counts[i];
+            histogram->total += counts[i];
+        }
+    }
+
+    return true;
+
+}// TwoDimensionalPlot::computeHistogram
 
 
 /*!
- * Generate a two dimensional plot of data with multiple dependent variables on
- * the left and right vertical axis. This version fills the entire scene, clearing
- * any data that was already there
+ * Generate a histogram of the samples of one data, filling the entire scene
+ * and clearing any data that was already there.
  * \param title is the plot title
  * \param xTicks is the approximate number of desired tick marks in the x axis
  * \param yTicks is the approximate number of desired tick marks in the y axis
- * \param xData is the x axis independent variable data
- * \param yData is one or more y axis dependent variable data
- * \param rData is one or more r axis (right vertical) dependent variable data
- * \param yScaleEqualsxScale should be true to force the y scale to match the x
- *        scale, which is useful for things that have physical shape.
- * \param rScaleEqualsxScale should be true to force the r scale to match the x
- *        scale, which is useful for things that have physical shape.
- * \param aspectRatio is used to control the aspect ratio (ratio of width to
- *        height). Pass 0 or negative to allow the aspect ratio to float
+ * \param data is the data to count
+ * \param bins is the approximate number of bins
  */
-void TwoDimensionalPlot::generatePlot(const QString & title, uint32_t xTicks, uint32_t yTicks, const plotData * xData, const plotSet & yData, const plotSet & rData, bool yScaleEqualsxScale, bool rScaleEqualsxScale, double aspectRatio)
+void TwoDimensionalPlot::generateHistogram(const QString & title, uint32_t xTicks, uint32_t yTicks, const plotData * data, uint32_t bins)
 {
-    myScene.clear();
+    // An asynchronous plot that is still being computed is now out of date
+    dropPendingPlot();
+
+    clear();
 
-    generatePlot(title, size, xTicks, yTicks, xData, yData, rData, yScaleEqualsxScale, rScaleEqualsxScale, aspectRatio);
+    generateHistogram(title, size, xTicks, yTicks, data, bins);
 
     fitAllInView();
 
-}// TwoDimensionalPlot::generatePlot
+}// TwoDimensionalPlot::generateHistogram
 
 
 /*!
- * Generate a two dimensional plot of data with multiple dependent variables on
- * the left and right vertical axis
+ * Generate a histogram of the samples of one data.  The x axis spans the
+ * bins and the y axis is the number of samples.  All the bars are one path.
  * \param title is the plot title
  * \param region is the scene/view region over which the plot should be generated
  * \param xTicks is the approximate number of desired tick marks in the x axis
  * \param yTicks is the approximate number of desired tick marks in the y axis
- * \param xData is the x axis independent variable data
- * \param yData is one or more y axis dependent variable data
- * \param rData is one or more r axis (right vertical) dependent variable data
- * \param yScaleEqualsxScale should be true to force the y scale to match the x
- *        scale, which is useful for things that have physical shape.
- * \param rScaleEqualsxScale should be true to force the r scale to match the x
- *        scale, which is useful for things that have physical shape.
- * \param aspectRatio is used to control the aspect ratio (ratio of width to
- *        height). Pass 0 or negative to allow the aspect ratio to float
+ * \param data is the data to count, its title labels the x axis and its color
+ *        fills the bars
+ * \param bins is the approximate number of bins
  */
-void TwoDimensionalPlot::generatePlot(const QString & title, QRectF region, uint32_t xTicks, uint32_t yTicks, const plotData * xData, const plotSet & yData, const plotSet & rData, bool yScaleEqualsxScale, bool rScaleEqualsxScale, double aspectRatio)
+void TwoDimensionalPlot::generateHistogram(const QString & title, QRectF region, uint32_t xTicks, uint32_t yTicks, const plotData * data, uint32_t bins)
 {
-    QPainterPath path;
+    plotHistogram histogram;
+    if(!computeHistogram(data, bins, &histogram))
+        return;
 
     // Origin of the grid in pixels
     double yOrg = region.bottom();
     double xOrg = region.left();
 
-    // Tick mark spacing details for the X axis
+    // The x axis spans the bins
     uint32_t numXticks = xTicks;
     double xMin, xMax;
-    int32_t xdigits = tickMarks(xData, &numXticks, &xMin, &xMax);
+    int32_t xdigits = TwoDimensionalScene::tickMarks(histogram.edge(0), histogram.edge(histogram.counts.size()), &numXticks, &xMin, &xMax);
 
-    // Tick mark spacing details for the Y axis
+    // The y axis counts from zero
     uint32_t numYticks = yTicks;
     double yMin, yMax;
-    int32_t ydigits = tickMarks(yData, &numYticks, &yMin, &yMax);
-
-    // Tick mark spacing details for the R axis
-    uint32_t numRticks = yTicks;
-    double rMin, rMax;
-    int32_t rdigits = tickMarks(rData, &numRticks, &rMin, &rMax);
-
-    // Now we have to decide whose tick marks to go with, the y or r axis.
-    //   Choose the larger of the two tick marks values, and then re-run the
-    //   other axis spacing, with a fixed number of tick marks
-    if(numYticks > numRticks)
-    {
-        numRticks = numYticks;
-        rdigits = tickMarks(rData, numRticks, &rMin, &rMax);
-    }
-    else if(numRticks > numYticks)
-    {
-        numYticks = numRticks;
-        ydigits = tickMarks(yData, numYticks, &yMin, &yMax);
-    }
-
-    double width = region.width();
-    double height = region.height();
-
-    // Does caller want to control the aspect ratio?
-    if(aspectRatio > 0)
-    {
-        if(height*aspectRatio > width)
-            height = width/aspectRatio;
-        else
-            width = height*aspectRatio;
-    }
+    TwoDimensionalScene::tickMarks(0.0, (double)histogram.largest(), &numYticks, &yMin, &yMax);
 
     // Figure out graph scaling, remember top - bottom is a negative number
-    double xScale = width/(xMax - xMin);
-    double yScale = height/(yMin - yMax);
-    double rScale = height/(rMin - rMax);
-
-    // For controlling plot distortion, remember that vertical dimensions have reversed sign
-    if(yScaleEqualsxScale)
-        yScale = -xScale;
-    if(rScaleEqualsxScale)
-        rScale = -xScale;
+    double xScale = region.width()/(xMax - xMin);
+    double yScale = region.height()/(yMin - yMax);
+    plotMapping map(xOrg, yOrg, xScale, yScale, xMin, yMin);
 
     // Draw the grid lines
     drawGrid(xOrg, yOrg, xScale, xMin, xMax, numXticks*2, yScale, yMin, yMax, numYticks*2);
 
     // The X axis and its tick marks and labels
-    if(xData->drawAxis)
-        DrawHorizontalAxis(xOrg, yOrg, xScale, xMin, xMax, numXticks, xData->title, xdigits, xData->color, xData->labelsHigh);
-
-    // The left vertical (Y) axis and its tick marks and lables
-    if(yData.size() > 0)
-        DrawVerticalAxis(xOrg, yOrg, yScale, yMin, yMax, numYticks, labelsFromPlotSet(yData), ydigits, colorsFromPlotSet(yData), !yData.at(0)->labelsHigh, drawFirstLabelFromPlotSet(yData));
+    if(data->drawAxis)
+        DrawHorizontalAxis(xOrg, yOrg, xScale, xMin, xMax, numXticks, data->title, xdigits, data->color, data->labelsHigh);
 
-    // The right vertical (R) axis and its tick marks and lables
-    if(rData.size() > 0)
-        DrawVerticalAxis(region.right(), yOrg, rScale, rMin, rMax, numRticks, labelsFromPlotSet(rData), rdigits, colorsFromPlotSet(rData), rData.at(0)->labelsHigh, drawFirstLabelFromPlotSet(rData));
+    // The Y axis, counts are whole numbers
+    DrawVerticalAxis(xOrg, yOrg, yScale, yMin, yMax, numYticks, QString("Count"), 0, Qt::black, true, false);
 
     // Add the title to the plot
     if(!title.isEmpty())
     {
         QPointF pos;
-        QGraphicsTextItem* item = myScene.addText(title);
+        QGraphicsTextItem* item = addText(title);
 
         // Title is centered at the top
         pos.setY(region.top());
         pos.setX((region.left()+region.right())*0.5);
         pos += rectOffsetForTopCenter(item->boundingRect());
-        item->setPos(pos);
+        placeText(item, pos);
     }
 
-    for(size_t j = 0; j < yData.size(); j++)
+    // One path for all the bars
+    QPainterPath bars;
+    for(size_t i = 0; i < histogram.counts.size(); i++)
     {
-        // Get the shorter of the two arrays, they should be the same, but the caller may make mistakes
-        size_t length = xData->data.size();
-        if(yData[j]->data.size() < length)
-            length = yData[j]->data.size();
-
-        // Skip this loop if we don't have enough data
-        if(length < 2)
+        if(histogram.counts[i] == 0)
             continue;
 
-        // starting point
-        double X = xOrg + (xData->data[0]*xData->scaler - xMin)*xScale;
-        double Y = yOrg + (yData[j]->data[0]*yData[j]->scaler - yMin)*yScale;
-        path.moveTo(X,Y);
+        bars.addRect(QRectF(QPointF(map.toX(histogram.edge(i)), map.toY((double)histogram.counts[i])),
+                            QPointF(map.toX(histogram.edge(i+1)), map.toY(0.0))).normalized());
+    }
 
-        for(size_t i = 1; i < length; i++)
-        {
-            X = xOrg + (xData->data[i]*xData->scaler - xMin)*xScale;
-            Y = yOrg + (yData[j]->data[i]*yData[j]->scaler - yMin)*yScale;
-            path.lineTo(X,Y);
+    QColor fill = data->color;
+    fill.setAlpha(160);
+    QGraphicsPathItem* item = addPath(bars, QPen(data->color));
+    item->setBrush(fill);
 
-        }// for all the solution points
+}// TwoDimensionalPlot::generateHistogram
 
-        // Put the path in the scene with the right color
-        myScene.addPath(path, yData[j]->color);
 
-        // reset for new path
-        path = QPainterPath();
+/*!
+ * Build the geometry for one curve, either a connected line or the markers
+ * of a scatter plot.  This only reads the data and allocates the geometry, so
+ * it can be run on a worker thread.
+ * \param xData is the x axis independent variable data
+ * \param yData is the dependent variable data of the curve
+ * \param map is the mapping from data values to scene coordinates
+ * \param slice is the range of samples to draw
+ * \param grid is the region of the scene covered by the grid
+ * \return the curve geometry
+ */
+plotCurve TwoDimensionalPlot::buildCurve(const plotData * xData, const plotData * yData, plotMapping map, plotSlice slice, QRectF grid)
+{
+    plotCurve curve;
+    curve.color = yData->color;
+    curve.markerSize = yData->markerSize;
+
+    if(yData->density)
+    {
+        curve.image = buildDensityImage(xData, yData, map, slice, grid);
+        curve.imagePos = grid.topLeft();
+    }
+    else if(yData->scatter)
+        curve.points = buildScatterPoints(xData, yData, map, slice, grid);
+    else
+        curve.line = buildCurveLine(xData, yData, map, slice);
 
-    }// For all curves plotted against the y axis
+    return curve;
+}
 
 
-    for(size_t j = 0; j < rData.size(); j++)
+/*!
+ * Add the items for one curve to the scene.  A curve is one item no matter
+ * how many points or markers it has.
+ * \param curve is the curve geometry from buildCurve()
+ * \param clip is the item that clips the curve to the grid, which can be null
+ */
+void TwoDimensionalPlot::addCurve(const plotCurve & curve, QGraphicsItem* clip)
+{
+    if(!curve.image.isNull())
+    {
+        QGraphicsPixmapItem* item = new QGraphicsPixmapItem(QPixmap::fromImage(curve.image), clip);
+        item->setPos(curve.imagePos);
+        if(clip == 0)
+            myScene.addItem(item);
+    }
+    else if(!curve.points.isEmpty())
+    {
+        ScatterItem* item = new ScatterItem(curve.points, curve.color, curve.markerSize, clip);
+        if(clip == 0)
+            myScene.addItem(item);
+    }
+    else if(!curve.line.isEmpty())
+    {
+        CurveItem* item = new CurveItem(curve.line, curve.color, clip);
+        if(clip == 0)
+            myScene.addItem(item);
+    }
+
+}// TwoDimensionalPlot::addCurve
+
+
+/*!
+ * Count the samples of a chunk of a density curve into a grid with one cell
+ * per pixel.  Samples outside the grid are not counted.
+ * \param xData is the x axis independent variable data
+ * \param yData is the dependent variable data of the curve
+ * \param map is the mapping from data values to scene coordinates
+ * \param grid is the region of the scene covered by the grid
+ * \param first is the index of the first sample of the chunk
+ * \param last is one past the index of the last sample of the chunk
+ * \return the count of each pixel, row by row from the top left corner of the grid
+ */
+static std::vector<uint32_t> chunkDensity(const plotData * xData, const plotData * yData, plotMapping map, QRectF grid, size_t first, size_t last)
+{
+    size_t width = (size_t)ceil(grid.width());
+    size_t height = (size_t)ceil(grid.height());
+    std::vector<uint32_t> counts(width*height, 0);
+
+    for(size_t i = first; i < last; i++)
     {
-        // Get the shorter of the two arrays, they should be the same, but the caller may make mistakes
-        size_t length = xData->data.size();
-        if(rData[j]->data.size() < length)
-            length = rData[j]->data.size();
+        double x = map.toX(xData->data[i]*xData->scaler) - grid.left();
+        double y = map.toY(yData->data[i]*yData->scaler) - grid.top();
 
-        // Skip this loop if we don't have enough data
-        if(length < 2)
+        // This also rejects NaN
+        if(!((x >= 0.0) && (x < width) && (y >= 0.0) && (y < height)))
             continue;
 
-        // starting point
-        double X = xOrg + (xData->data[0]*xData->scaler - xMin)*xScale;
-        double Y = yOrg + (rData[j]->data[0]*rData[j]->scaler - rMin)*rScale;
-        path.moveTo(X,Y);
+        counts[((size_t)y)*width + (size_t)x]++;
+    }
+
+    return counts;
+
+}// chunkDensity
+
+
+/*!
+ * Build the heat map for one density curve.  The samples are split into
+ * chunks that are counted on the thread pool, each into its own grid of
+ * pixels, and the grids are added at the end.  The counts are mapped through
+ * the heat color map on a log scale, so sparse pixels still show, and empty
+ * pixels are transparent.  This can be run on a worker thread.
+ * \param xData is the x axis independent variable data
+ * \param yData is the dependent variable data of the curve
+ * \param map is the mapping from data values to scene coordinates
+ * \param slice is the range of samples to draw
+ * \param grid is the region of the scene covered by the grid
+ * \return the heat map, which covers the grid starting at its top left
+ *         corner, or a null image if there is no data
+ */
+QImage TwoDimensionalPlot::buildDensityImage(const plotData * xData, const plotData * yData, plotMapping map, plotSlice slice, QRectF grid)
+{
+    // Get the shorter of the two arrays, they should be the same, but the caller may make mistakes
+    size_t length = xData->data.size();
+    if(yData->data.size() < length)
+        length = yData->data.size();
+
+    // Only the samples in the slice are counted
+    size_t first = slice.first;
+    size_t last = slice.last;
+    if(last >= length)
+        last = length - 1;
+
+    int width = (int)ceil(grid.width());
+    int height = (int)ceil(grid.height());
+    if((length == 0) || (first > last) || (width <= 0) || (height <= 0))
+        return QImage();
+
+    // Every chunk has a whole grid, so use fewer chunks than for a histogram
+    size_t samples = last - first + 1;
+    size_t chunks = chunksForSamples(samples);
+    if(chunks > (size_t)QThread::idealThreadCount())
+        chunks = (size_t)QThread::idealThreadCount();
+    if(chunks < 1)
+        chunks = 1;
+
+    QList< QFuture< std::vector<uint32_t> > > partials;
+    for(size_t k = 0; k < chunks; k++)
+    {
+        size_t begin = first + (samples*k)/chunks;
+        size_t end = first + (samples*(k+1))/chunks;
+        partials.append(QtConcurrent::run([=]() {return chunkDensity(xData, yData, map, grid, begin, end);}));
+    }
+
+    // Merge the partial grids
+    std::vector<uint32_t> counts = partials[0].result();
+    for(int k = 1; k < partials.size(); k++)
+    {
+        std::vector<uint32_t> partial = partials[k].result();
+        for(size_t i = 0; i < counts.size(); i++)
+            counts[i] += partial[i];
+    }
+
+    uint32_t most = 0;
+    for(size_t i = 0; i < counts.size(); i++)
+    {
+        if(counts[i] > most)
+            most = counts[i];
+    }
+
+    if(most == 0)
+        return QImage();
+
+    // Entry 0 of the table is transparent for empty pixels, so the grid shows through
+    QVector<QRgb> table = ColorMap::heat().colorTable();
+    table[0] = qRgba(0, 0, 0, 0);
 
-        for(size_t i = 1; i < length; i++)
+    QImage image(width, height, QImage::Format_Indexed8);
+    image.setColorTable(table);
+
+    // Count to color on a log scale, every pixel with samples gets at least entry 1
+    double scale = (ColorMap::entries - 2)/log(1.0 + most);
+    for(int row = 0; row < height; row++)
+    {
+        uchar* line = image.scanLine(row);
+        const uint32_t* source = counts.data() + ((size_t)row)*width;
+        for(int column = 0; column < width; column++)
         {
-            X = xOrg + (xData->data[i]*xData->scaler - xMin)*xScale;
-            Y = yOrg + (rData[j]->data[i]*rData[j]->scaler - rMin)*rScale;
-            path.lineTo(X,Y);
+            if(source[column] == 0)
+                line[column] = 0;
+            else
+                line[column] = (uchar)(1 + (int)(log(1.0 + source[column])*scale));
+        }
+    }
 
-        }// for all the solution points
+    return image;
 
-        // Put the path in the scene with the right color
-        myScene.addPath(path, rData[j]->color);
+}// TwoDimensionalPlot::buildDensityImage
 
-        // reset for new path
-        path = QPainterPath();
 
-     }// For all curves plotted against the r axis
+/*!
+ * Build the markers for one scatter curve.  Markers outside the grid are not
+ * drawn, and where markers overlap heavily only the first marker in each
+ * pixel is kept.  This can be run on a worker thread.
+ * \param xData is the x axis independent variable data
+ * \param yData is the dependent variable data of the curve
+ * \param map is the mapping from data values to scene coordinates
+ * \param slice is the range of samples to draw
+ * \param grid is the region of the scene covered by the grid
+ * \return the center of every marker, in scene coordinates
+ */
+QVector<QPointF> TwoDimensionalPlot::buildScatterPoints(const plotData * xData, const plotData * yData, plotMapping map, plotSlice slice, QRectF grid)
+{
+    QVector<QPointF> points;
 
-}// TwoDimensionalPlot::generatePlot
+    // Get the shorter of the two arrays, they should be the same, but the caller may make mistakes
+    size_t length = xData->data.size();
+    if(yData->data.size() < length)
+        length = yData->data.size();
+
+    if(length == 0)
+        return points;
+
+    // Only the samples in the slice are drawn
+    size_t first = slice.first;
+    size_t last = slice.last;
+    if(last >= length)
+        last = length - 1;
+
+    if(first > last)
+        return points;
+
+    points.reserve((int)(last - first + 1));
+    for(size_t i = first; i <= last; i++)
+        points.append(QPointF(map.toX(xData->data[i]*xData->scaler), map.toY(yData->data[i]*yData->scaler)));
+
+    return ScatterItem::reducePoints(points, grid);
+
+}// TwoDimensionalPlot::buildScatterPoints
+
+
+/*!
+ * Build the line for one curve.  This only reads the data and allocates the
+ * line, so it can be run on a worker thread.
+ * \param xData is the x axis independent variable data
+ * \param yData is the dependent variable data of the curve
+ * \param map is the mapping from data values to scene coordinates
+ * \param slice is the range of samples to draw
+ * \return the points of the line, which will be empty if there is not enough data
+ */
+QVector<QPointF> TwoDimensionalPlot::buildCurveLine(const plotData * xData, const plotData * yData, plotMapping map, plotSlice slice)
+{
+    QVector<QPointF> line;
+
+    // Get the shorter of the two arrays, they should be the same, but the caller may make mistakes
+    size_t length = xData->data.size();
+    if(yData->data.size() < length)
+        length = yData->data.size();
+
+    // Skip this curve if we don't have enough data
+    if(length < 2)
+        return line;
+
+    // Only the samples in the slice are drawn
+    size_t first = slice.first;
+    size_t last = slice.last;
+    if(last >= length)
+        last = length - 1;
+
+    if(first >= last)
+        return line;
+
+    // With increasing x and many samples per pixel, draw the block minimum and
+    //   maximum from the coarsest pyramid level that still has a block per pixel
+    size_t level;
+    double pixels = fabs((xData->data[last] - xData->data[first])*xData->scaler*map.xScale);
+    if(slice.increasing && (length == yData->data.size()) && yData->hasPyramid() &&
+        (pixels > 0.0) && yData->pyramid.levelForSamples((last - first + 1)/pixels, &level))
+    {
+        size_t block = MinMaxPyramid::blockSize(level);
+
+        line.reserve((int)(2*(last/block - first/block + 1)));
+        for(size_t k = first/block; k <= last/block; k++)
+        {
+            double X = map.toX(xData->data[k*block]*xData->scaler);
+
+            line.append(QPointF(X, map.toY(yData->pyramid.minimum(level, k))));
+            line.append(QPointF(X, map.toY(yData->pyramid.maximum(level, k))));
+
+        }// for all blocks in the slice
+
+        return line;
+
+    }// if drawing from the pyramid
+
+    // Every sample in the slice
+    line.reserve((int)(last - first + 1));
+    for(size_t i = first; i <= last; i++)
+        line.append(QPointF(map.toX(xData->data[i]*xData->scaler), map.toY(yData->data[i]*yData->scaler)));
+
+    return line;
+
+}// TwoDimensionalPlot::buildCurveLine
+
+
+/*!
+ * Find the samples of increasing x data that are needed to draw a range of x
+ * values, using a binary search.  The slice includes one sample before and
+ * one sample after the range so the curves reach the edges.
+ * \param xData is the x axis data, whose scaled values must never decrease
+ * \param minValue is the smallest x value that is visible
+ * \param maxValue is the largest x value that is visible
+ * \param first receives the index of the first sample to draw
+ * \param last receives the index of the last sample to draw
+ */
+void TwoDimensionalPlot::visibleSamples(const plotData * xData, double minValue, double maxValue, size_t* first, size_t* last)
+{
+    const array & x = xData->data;
+    double scaler = xData->scaler;
+
+    *first = *last = 0;
+    if(x.empty())
+        return;
+
+    // The first sample at or above the minimum
+    size_t low = 0;
+    size_t high = x.size();
+    while(low < high)
+    {
+        size_t mid = low + (high - low)/2;
+        if(x[mid]*scaler < minValue)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    // Back up one sample so the curve runs to the left edge
+    *first = (low > 0) ? low - 1 : 0;
+
+    // The first sample above the maximum
+    high = x.size();
+    while(low < high)
+    {
+        size_t mid = low + (high - low)/2;
+        if(x[mid]*scaler <= maxValue)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    // This sample lets the curve run to the right edge
+    *last = (low < x.size()) ? low : x.size() - 1;
+
+}// TwoDimensionalPlot::visibleSamples
 
 
 /*!
@@ -354,24 +1571,64 @@ int32_t TwoDimensionalPlot::tickMarks(const plotData * axis, uint32_t* numTicks,
  */
 bool TwoDimensionalPlot::getRange(const plotData * axis, double* minValue, double* maxValue)
 {
-    if(axis->data.size() > 1)
+    return getRange(axis, 0, std::numeric_limits<size_t>::max(), minValue, maxValue);
+
+}// TwoDimensionalPlot::getRange
+
+
+/*!
+ * return the range of a slice of data in a array.  If the array has a min/max
+ * pyramid the cost is logarithmic in the length of the slice.
+ * \param axis is the axis single variable data set
+ * \param first is the index of the first sample of the slice
+ * \param last is the index of the last sample of the slice, which is limited
+ *        to the end of the array
+ * \param minValue receives the minimum value in the slice
+ * \param maxValue receives the maximum value in the slice
+ * \return true if the array contains two or more entries and the slice is
+ *         not empty, else false
+ */
+bool TwoDimensionalPlot::getRange(const plotData * axis, size_t first, size_t last, double* minValue, double* maxValue)
+{
+    if((axis->data.size() > 1) && (first < axis->data.size()))
     {
-        // Initial value, this is where we can force zero as part of the range if requested
-        if(axis->includeZero)
-            *minValue = *maxValue = 0.0;
+        if(last >= axis->data.size())
+            last = axis->data.size() - 1;
+
+        if(last < first)
+            return false;
+
+        double low, high;
+
+        if(axis->hasPyramid())
+            axis->pyramid.range(axis->data, axis->scaler, first, last, &low, &high);
         else
-            *minValue = *maxValue = axis->data[0]*axis->scaler;
+        {
+            low = high = axis->data[first]*axis->scaler;
+
+            // Get the min and max range of the data
+            for(size_t i = first; i <= last; i++)
+            {
+                double value = axis->data[i]*axis->scaler;
+                if(value < low)
+                    low = value;
+                else if(value > high)
+                    high = value;
+
+            }// for all data entries
+        }
 
-        // Get the min and max range of the data
-        for(size_t i = 0; i < axis->data.size(); i++)
+        // This is where we can force zero as part of the range if requested
+        if(axis->includeZero)
         {
-            double value = axis->data[i]*axis->scaler;
-            if(value < *minValue)
-                *minValue = value;
-            else if(value > *maxValue)
-                *maxValue = value;
+            if(low > 0.0)
+                low = 0.0;
+            if(high < 0.0)
+                high = 0.0;
+        }
 
-        }// for all data entries
+        *minValue = low;
+        *maxValue = high;
 
         return true;
     }
@@ -392,10 +1649,42 @@ bool TwoDimensionalPlot::getRange(const plotData * axis, double* minValue, doubl
  * \return the number of decimal digits after the point needed to display the full resolution of the tick mark spacing
  */
 int32_t TwoDimensionalPlot::tickMarks(const plotSet & set, uint32_t numTicks, double* startValue, double* endValue)
+{
+    return tickMarks(set, 0, std::numeric_limits<size_t>::max(), numTicks, startValue, endValue);
+
+}// TwoDimensionalPlot::tickMarks
+
+
+/*!
+ * Compute tick mark information for an axis plot set
+ * \param set is the axis data set
+ * \param numTicks is the suggested number of tick marks to include, and will be updated with the correct number
+ * \param startValue receives the starting value for the axis
+ * \param endValue receives the ending value for the axis
+ * \return the number of decimal digits after the point needed to display the full resolution of the tick mark spacing
+ */
+int32_t TwoDimensionalPlot::tickMarks(const plotSet & set, uint32_t* numTicks, double* startValue, double* endValue)
+{
+    return tickMarks(set, 0, std::numeric_limits<size_t>::max(), numTicks, startValue, endValue);
+
+}// TwoDimensionalPlot::tickMarks
+
+
+/*!
+ * Compute tick mark information for a slice of an axis plot set
+ * \param set is the axis data set
+ * \param first is the index of the first sample of the slice
+ * \param last is the index of the last sample of the slice
+ * \param numTicks is the number of tick marks to include
+ * \param startValue receives the starting value for the axis
+ * \param endValue receives the ending value for the axis
+ * \return the number of decimal digits after the point needed to display the full resolution of the tick mark spacing
+ */
+int32_t TwoDimensionalPlot::tickMarks(const plotSet & set, size_t first, size_t last, uint32_t numTicks, double* startValue, double* endValue)
 {
     double minValue, maxValue;
 
-    if(getRange(set, &minValue, &maxValue))
+    if(getRange(set, first, last, &minValue, &maxValue))
         return TwoDimensionalScene::tickMarks(minValue, maxValue, numTicks, startValue, endValue);
     else
     {
@@ -408,18 +1697,20 @@ int32_t TwoDimensionalPlot::tickMarks(const plotSet & set, uint32_t numTicks, do
 
 
 /*!
- * Compute tick mark information for an axis plot set
+ * Compute tick mark information for a slice of an axis plot set
  * \param set is the axis data set
+ * \param first is the index of the first sample of the slice
+ * \param last is the index of the last sample of the slice
  * \param numTicks is the suggested number of tick marks to include, and will be updated with the correct number
  * \param startValue receives the starting value for the axis
  * \param endValue receives the ending value for the axis
  * \return the number of decimal digits after the point needed to display the full resolution of the tick mark spacing
  */
-int32_t TwoDimensionalPlot::tickMarks(const plotSet & set, uint32_t* numTicks, double* startValue, double* endValue)
+int32_t TwoDimensionalPlot::tickMarks(const plotSet & set, size_t first, size_t last, uint32_t* numTicks, double* startValue, double* endValue)
 {
     double minValue, maxValue;
 
-    if(getRange(set, &minValue, &maxValue))
+    if(getRange(set, first, last, &minValue, &maxValue))
         return TwoDimensionalScene::tickMarks(minValue, maxValue, numTicks, startValue, endValue);
     else
     {
@@ -441,48 +1732,89 @@ int32_t TwoDimensionalPlot::tickMarks(const plotSet & set, uint32_t* numTicks, d
  */
 bool TwoDimensionalPlot::getRange(const plotSet & set, double* minValue, double* maxValue)
 {
-    size_t i;
+    return getRange(set, 0, std::numeric_limits<size_t>::max(), minValue, maxValue);
 
-    // Get the initial values
-    for(i = 0; i < set.size(); i++)
-    {
-        if(set[i]->data.size() > 0)
-        {
-            *minValue = *maxValue = set[i]->data[0]*set[i]->scaler;
-            break;
-        }
-    }
+}// TwoDimensionalPlot::getRange
 
-    // If we have no data, then get out
-    if(i >= set.size())
-        return false;
 
-    for(i = 0; i < set.size(); i++)
+/*!
+ * return the range of a slice of data in a plot set
+ * \param set is the set of multiple arrays of data
+ * \param first is the index of the first sample of the slice
+ * \param last is the index of the last sample of the slice, which is limited
+ *        to the end of each array
+ * \param minValue receives the minimum value in the slice
+ * \param maxValue receives the maximum value in the slice
+ * \return true if any array has data in the slice, else false
+ */
+bool TwoDimensionalPlot::getRange(const plotSet & set, size_t first, size_t last, double* minValue, double* maxValue)
+{
+    bool valid = false;
+    bool zero = false;
+
+    for(size_t i = 0; i < set.size(); i++)
     {
-        double value = 0.0;
+        const array & data = set[i]->data;
 
         // Make sure zero is included if asked
         if(set[i]->includeZero)
+            zero = true;
+
+        if(first >= data.size())
+            continue;
+
+        size_t end = last;
+        if(end >= data.size())
+            end = data.size() - 1;
+
+        double low, high;
+
+        if(set[i]->hasPyramid())
+            set[i]->pyramid.range(data, set[i]->scaler, first, end, &low, &high);
+        else
         {
-            if(value < *minValue)
-                *minValue = value;
-            else if(value > *maxValue)
-                *maxValue = value;
+            low = high = data[first]*set[i]->scaler;
+
+            // Get the min and max range of the data
+            for(size_t j = first; j <= end; j++)
+            {
+                double value = data[j]*set[i]->scaler;
+
+                if(value < low)
+                    low = value;
+                else if(value > high)
+                    high = value;
+
+            }// for all data entries
         }
 
-        // Get the min and max range of the data
-        for(size_t j = 0; j < set[i]->data.size(); j++)
+        if(!valid)
+        {
+            *minValue = low;
+            *maxValue = high;
+            valid = true;
+        }
+        else
         {
-            value = set[i]->data[j]*set[i]->scaler;
+            if(low < *minValue)
+                *minValue = low;
+            if(high > *maxValue)
+                *maxValue = high;
+        }
 
-            if(value < *minValue)
-                *minValue = value;
-            else if(value > *maxValue)
-                *maxValue = value;
+    }// for all sets
 
-        }// for all data entries
+    // If we have no data, then get out
+    if(!valid)
+        return false;
 
-    }// for all sets
+    if(zero)
+    {
+        if(*minValue > 0.0)
+            *minValue = 0.0;
+        if(*maxValue < 0.0)
+            *maxValue = 0.0;
+    }
 
     return true;
 
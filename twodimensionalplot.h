@@ -2,13 +2,24 @@
 #define TWODIMENSIONALPLOT_H
 
 #include "twodimensionalscene.h"
+#include "minmaxpyramid.h"
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QImage>
 #include <QList>
+#include <QPointF>
 #include <QRectF>
 #include <QStringList>
+#include <QVector>
+#include <functional>
+#include <limits>
+#include <memory>
 #include <vector>
 
 typedef std::vector<double> array;
 
+class plotHoverIndex;
+
 class plotData
 {
 public:
@@ -17,15 +28,55 @@ public:
         includeZero(false),
         drawAxis(true),
         drawFirstLabel(false),
-        labelsHigh(false)
+        labelsHigh(false),
+        scatter(false),
+        markerSize(3.0),
+        density(false),
+        declaredIncreasing(-1),
+        detectedIncreasing(-1),
+        detectedSamples(0),
+        detectedScaler(1.0)
     {
     }
 
     plotData(const array & x, QString z = QString(), QColor y = Qt::black) :
-        data(x), color(y), title(z), scaler(1.0), includeZero(false), drawAxis(true), drawFirstLabel(true), labelsHigh(false)
+        data(x), color(y), title(z), scaler(1.0), includeZero(false), drawAxis(true), drawFirstLabel(true), labelsHigh(false),
+        scatter(false), markerSize(3.0), density(false), declaredIncreasing(-1), detectedIncreasing(-1), detectedSamples(0), detectedScaler(1.0)
     {
     }
 
+    //! Copy the data and description, and the pyramid if it is finished
+    plotData(const plotData & other);
+
+    ~plotData()
+    {
+        pyramidBuild.waitForFinished();
+    }
+
+    //! Copy the data and description, and the pyramid if it is finished
+    plotData & operator=(const plotData & other);
+
+    //! Build the min/max pyramid used to draw long curves quickly
+    void buildPyramid(void);
+
+    //! Build the min/max pyramid on the thread pool
+    void buildPyramidInBackground(void);
+
+    //! \return true if the min/max pyramid is finished and matches the data
+    bool hasPyramid(void) const;
+
+    //! \return true if the scaled data never decreases
+    bool isIncreasing(void) const;
+
+    //! Declare if the scaled data never decreases, so it does not have to be detected
+    void setIncreasing(bool increasing) {declaredIncreasing = increasing ? 1 : 0;}
+
+    //! Forget any declaration and detect if the scaled data never decreases
+    void detectIncreasing(void) {declaredIncreasing = -1;}
+
+    //! Forget everything learned from the data, call this after editing the data in place
+    void dataChanged(void);
+
     array data;
     QColor color;
     QString title;
@@ -34,26 +85,223 @@ public:
     bool drawAxis;
     bool drawFirstLabel;
     bool labelsHigh;
+    bool scatter;               //!< True to draw a marker at each sample instead of a connected line
+    double markerSize;          //!< Diameter of the scatter markers in pixels, 1 or less for single pixels
+    bool density;               //!< True to draw the number of samples in each pixel as a heat map instead of a line or markers
+    MinMaxPyramid pyramid;      //!< Block minimums and maximums of the scaled data
+    QFuture<void> pyramidBuild; //!< Background build of the pyramid
+    int declaredIncreasing;     //!< 1 or 0 if the caller declared the data increasing or not, -1 to detect it
+    mutable int detectedIncreasing; //!< 1 or 0 from the last detection, -1 if not detected
+    mutable size_t detectedSamples; //!< Number of samples when the detection was done
+    mutable double detectedScaler;  //!< Scaler when the detection was done
 };
 
 
 //! Multiple arrays of data for plotting
 typedef std::vector<const plotData *> plotSet;
 
+
+//! A private copy of the data of a plot, so the plot can be built on a worker thread
+class plotSnapshot
+{
+public:
+    plotSnapshot(const plotData * xData, const plotSet & yData, const plotSet & rData);
+
+    plotData x;             //!< Copy of the x data
+    std::vector<plotData> y;//!< Copies of the y data
+    std::vector<plotData> r;//!< Copies of the r data
+    plotSet ySet;           //!< Pointers to the copies of the y data
+    plotSet rSet;           //!< Pointers to the copies of the r data
+};
+
+
+//! Mapping from data values to scene coordinates for one pair of axes
+class plotMapping
+{
+public:
+    plotMapping() :
+        xOrg(0.0), yOrg(0.0), xScale(1.0), yScale(1.0), xMin(0.0), yMin(0.0)
+    {
+    }
+
+    plotMapping(double xo, double yo, double xs, double ys, double xm, double ym) :
+        xOrg(xo), yOrg(yo), xScale(xs), yScale(ys), xMin(xm), yMin(ym)
+    {
+    }
+
+    //! \return the scene x coordinate of a scaled x data value
+    double toX(double x) const {return xOrg + (x - xMin)*xScale;}
+
+    //! \return the scene y coordinate of a scaled y data value
+    double toY(double y) const {return yOrg + (y - yMin)*yScale;}
+
+    double xOrg;    //!< Scene x coordinate of the origin
+    double yOrg;    //!< Scene y coordinate of the origin
+    double xScale;  //!< Pixels per x unit
+    double yScale;  //!< Pixels per y unit, negative because scene y points down
+    double xMin;    //!< x value at the origin
+    double yMin;    //!< y value at the origin
+};
+
+
+//! The slice of samples that needs to be drawn
+class plotSlice
+{
+public:
+    plotSlice() :
+        first(0), last(std::numeric_limits<size_t>::max()), increasing(false)
+    {
+    }
+
+    size_t first;       //!< Index of the first sample to draw
+    size_t last;        //!< Index of the last sample to draw, may be past the end of the data
+    bool increasing;    //!< True if the x data never decreases
+};
+
+
+//! The geometry of one curve, which can be built on a worker thread
+class plotCurve
+{
+public:
+    plotCurve() :
+        markerSize(0.0)
+    {
+    }
+
+    QVector<QPointF> line;      //!< The connected line, empty for scatter data
+    QVector<QPointF> points;    //!< The scatter markers, empty for line data
+    QImage image;               //!< The density heat map, null unless density data
+    QPointF imagePos;           //!< Scene location of the top left corner of the heat map
+    QColor color;               //!< Color of the curve
+    double markerSize;          //!< Diameter of the scatter markers in pixels
+};
+
+
+//! Everything needed to draw a plot, computed from the data on a worker thread
+class plotLayout
+{
+public:
+    //! \return true if the grid, axes, and title of another layout are drawn the same
+    bool sameAxes(const plotLayout & other) const;
+
+    plotLayout() :
+        xOrg(0.0), yOrg(0.0), xScale(1.0), yScale(-1.0), rScale(-1.0),
+        xMin(0.0), xMax(1.0), yMin(0.0), yMax(1.0), rMin(0.0), rMax(1.0),
+        numXticks(0), numYticks(0), numRticks(0), xdigits(0), ydigits(0), rdigits(0),
+        xDrawAxis(false), xLabelsHigh(false),
+        yAxis(false), yLeft(true), yFirstLabel(false),
+        rAxis(false), rLeft(false), rFirstLabel(false),
+        clip(false)
+    {
+    }
+
+    QString title;          //!< The plot title
+    QRectF region;          //!< Region of the scene the plot covers
+    double xOrg;            //!< Scene x coordinate of the origin of the grid
+    double yOrg;            //!< Scene y coordinate of the origin of the grid
+    double xScale;          //!< Pixels per x unit
+    double yScale;          //!< Pixels per y unit, negative because scene y points down
+    double rScale;          //!< Pixels per r unit, negative because scene y points down
+    double xMin;            //!< Start of the x axis
+    double xMax;            //!< End of the x axis
+    double yMin;            //!< Start of the y axis
+    double yMax;            //!< End of the y axis
+    double rMin;            //!< Start of the r axis
+    double rMax;            //!< End of the r axis
+    uint32_t numXticks;     //!< Number of x axis tick marks
+    uint32_t numYticks;     //!< Number of y axis tick marks
+    uint32_t numRticks;     //!< Number of r axis tick marks
+    int32_t xdigits;        //!< Precision of the x axis labels
+    int32_t ydigits;        //!< Precision of the y axis labels
+    int32_t rdigits;        //!< Precision of the r axis labels
+    QString xTitle;         //!< Title of the x axis
+    QColor xColor;          //!< Color of the x axis
+    bool xDrawAxis;         //!< True to draw the x axis
+    bool xLabelsHigh;       //!< True to put the x axis labels above the axis
+    bool yAxis;             //!< True if there is a y axis
+    QStringList yLabels;    //!< Titles of the y axis
+    QList<QColor> yColors;  //!< Colors of the y axis titles
+    bool yLeft;             //!< True if the y axis labels are to the left of the axis
+    bool yFirstLabel;       //!< True to draw the first y axis label
+    bool rAxis;             //!< True if there is an r axis
+    QStringList rLabels;    //!< Titles of the r axis
+    QList<QColor> rColors;  //!< Colors of the r axis titles
+    bool rLeft;             //!< True if the r axis labels are to the left of the axis
+    bool rFirstLabel;       //!< True to draw the first r axis label
+    QRectF grid;            //!< Region of the scene covered by the grid
+    bool clip;              //!< True if the curves are clipped to the grid
+    QRectF curveBounds;     //!< Region of the scene the curves can cover
+    std::vector<plotCurve> curves;  //!< The y curves, then the r curves
+    std::shared_ptr<const plotHoverIndex> hover;    //!< Finds the sample under the mouse, null for no hover readout
+};
+
+
+//! The number of samples of a plot data in each of a set of equal width bins
+class plotHistogram
+{
+public:
+    plotHistogram() :
+        start(0.0), width(1.0), digits(0), total(0)
+    {
+    }
+
+    //! \return the low edge of a bin
+    double edge(size_t bin) const {return start + bin*width;}
+
+    //! \return the largest count of any bin
+    uint64_t largest(void) const;
+
+    double start;                   //!< Low edge of the first bin
+    double width;                   //!< Width of every bin
+    int32_t digits;                 //!< Number of decimal digits needed to show the bin edges
+    uint64_t total;                 //!< Number of samples counted
+    std::vector<uint64_t> counts;   //!< Number of samples in each bin
+};
+
+
 class TwoDimensionalPlot : public TwoDimensionalScene
 {
 public:
     TwoDimensionalPlot();
 
+    ~TwoDimensionalPlot();
+
     //! Plot of data with multiple dependent variables on the left and right vertical axis
     void generatePlot(const QString & title, uint32_t xTicks, uint32_t yTicks, const plotData * xData, const plotSet & yData, const plotSet & rData, bool yScaleEqualsxScale = false, bool rScaleEqualsxScale = false, double aspectRatio = -1.0);
 
+    //! Histogram of the samples of one data, filling the scene
+    void generateHistogram(const QString & title, uint32_t xTicks, uint32_t yTicks, const plotData * data, uint32_t bins = 50);
+
+    //! Histogram of the samples of one data, in a region of the scene
+    void generateHistogram(const QString & title, QRectF region, uint32_t xTicks, uint32_t yTicks, const plotData * data, uint32_t bins = 50);
+
+    //! Plot of data with multiple dependent variables, with the data work done on the thread pool
+    QFuture<void> generatePlotAsync(const QString & title, uint32_t xTicks, uint32_t yTicks, const plotData * xData, const plotSet & yData, const plotSet & rData, bool yScaleEqualsxScale = false, bool rScaleEqualsxScale = false, double aspectRatio = -1.0, std::function<void(void)> drawn = std::function<void(void)>());
+
     //! Plot of data with multiple dependent variables on the left and right vertical axis
     void generatePlot(const QString & title, QRectF region, uint32_t xTicks, uint32_t yTicks, const plotData * xData, const plotSet & yData, const plotSet & rData, bool yScaleEqualsxScale = false, bool rScaleEqualsxScale = false, double aspectRatio = -1.0);
 
     //! Make sure everything that was drawn is in view
     void fitAllInView(void);
 
+    //! Make sure a region of the scene is in view
+    void fitAllInView(const QRectF & sceneRect);
+
+    //! Set the range of the x axis, instead of fitting it to the data
+    void setXRange(double minValue, double maxValue);
+
+    //! Fit the x axis to the data
+    void clearXRange(void);
+
+    //! \return true if the x axis range is set by setXRange()
+    bool getXRangeSet(void) const {return xRangeSet;}
+
+    //! Show a crosshair and the values of every channel under the mouse on plots generated after this
+    void setHoverReadout(bool enable) {hoverReadout = enable;}
+
+    //! \return true if plots show a crosshair and the values under the mouse
+    bool getHoverReadout(void) const {return hoverReadout;}
+
     //! Determine if the first label of the axis should be drawn
     static bool drawFirstLabelFromPlotSet(const plotSet & set);
 
@@ -81,6 +329,79 @@ public:
     //! return the range of data in a plot set
     static bool getRange(const plotSet & set, double* minValue, double* maxValue);
 
+    //! Get the range of a slice of data in a array
+    static bool getRange(const plotData * axis, size_t first, size_t last, double* minValue, double* maxValue);
+
+    //! return the range of a slice of data in a plot set
+    static bool getRange(const plotSet & set, size_t first, size_t last, double* minValue, double* maxValue);
+
+    //! Count the samples of one data in bins, using the thread pool
+    static bool computeHistogram(const plotData * data, uint32_t bins, plotHistogram* histogram);
+
+    //! Get the range of data in a array, using the thread pool
+    static bool parallelRange(const plotData * axis, double* minValue, double* maxValue);
+
+    //! Find the samples of increasing x data that are needed to draw a range of x
+    static void visibleSamples(const plotData * xData, double minValue, double maxValue, size_t* first, size_t* last);
+
+protected:
+
+    //! Compute tick mark information for a slice of an axis plot set
+    static int32_t tickMarks(const plotSet & set, size_t first, size_t last, uint32_t numTicks, double* startValue, double* endValue);
+
+    //! Compute tick mark information for a slice of an axis plot set
+    static int32_t tickMarks(const plotSet & set, size_t first, size_t last, uint32_t* numTicks, double* startValue, double* endValue);
+
+    //! Compute the layout of a plot from the data, safe to call from a worker thread
+    static plotLayout computeLayout(const QString & title, QRectF region, uint32_t xTicks, uint32_t yTicks, const plotData * xData, const plotSet & yData, const plotSet & rData, bool yScaleEqualsxScale, bool rScaleEqualsxScale, double aspectRatio, bool zoomed, double zoomMin, double zoomMax, std::shared_ptr<const plotSnapshot> hoverData);
+
+    //! Compute the layout of a plot from the data, with the hover readout if enabled
+    plotLayout layoutPlot(const QString & title, QRectF region, uint32_t xTicks, uint32_t yTicks, const plotData * xData, const plotSet & yData, const plotSet & rData, bool yScaleEqualsxScale, bool rScaleEqualsxScale, double aspectRatio) const;
+
+    //! Draw a plot layout into the scene
+    void drawLayout(const plotLayout & layout, bool reuseAxes = false);
+
+    //! Draw the grid, axes, and title of a plot layout
+    void drawAxes(const plotLayout & layout);
+
+    //! Remove everything from the scene except the cached axis layer
+    void clearExceptAxes(void);
+
+    //! \return true if the cached axis layer is still in the scene
+    bool hasAxisLayer(void) const {return (axisLayer != 0) && (axisClears == clears);}
+
+    //! Replace the scene with the plot computed by generatePlotAsync()
+    void swapInLayout(void);
+
+    //! Drop the plot from generatePlotAsync() that is in flight
+    void dropPendingPlot(void);
+
+    //! Build the geometry for one curve, safe to call from a worker thread
+    static plotCurve buildCurve(const plotData * xData, const plotData * yData, plotMapping map, plotSlice slice, QRectF grid);
+
+    //! Build the line for one curve, safe to call from a worker thread
+    static QVector<QPointF> buildCurveLine(const plotData * xData, const plotData * yData, plotMapping map, plotSlice slice);
+
+    //! Build the heat map for one density curve, safe to call from a worker thread
+    static QImage buildDensityImage(const plotData * xData, const plotData * yData, plotMapping map, plotSlice slice, QRectF grid);
+
+    //! Build the markers for one scatter curve, safe to call from a worker thread
+    static QVector<QPointF> buildScatterPoints(const plotData * xData, const plotData * yData, plotMapping map, plotSlice slice, QRectF grid);
+
+    //! Add the items for one curve to the scene
+    void addCurve(const plotCurve & curve, QGraphicsItem* clip);
+
+protected:
+    bool xRangeSet;     //!< True if the x axis range is set by the user
+    double xRangeMin;   //!< The user's minimum x value
+    double xRangeMax;   //!< The user's maximum x value
+    bool hoverReadout;  //!< True to show a crosshair and the values under the mouse
+    QGraphicsItem* axisLayer;   //!< Parent of the cached grid, axes, and title
+    uint64_t axisClears;        //!< The scene clear count when the axis layer was made
+    plotLayout axisKey;         //!< The layout the axis layer was drawn from, without its curves
+    QRectF axisBounds;          //!< Region of the scene covered by the axis layer
+    QFutureWatcher<plotLayout>* layoutWatcher;  //!< Watches the plot computed by generatePlotAsync()
+    std::function<void(void)> plotDrawn;        //!< Called when the plot from generatePlotAsync() is in the scene
 };
 
 #endif // TWODIMENSIONALPLOT_H
@@ -1,11 +1,180 @@
 #include "twodimensionalscene.h"
 #include <math.h>
 #include <QGraphicsTextItem>
+#include <QGraphicsPathItem>
+#include <QPainter>
+#include <QPicture>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <vector>
+#include "tiffstripwriter.h"
+
+TwoDimensionalScene::TwoDimensionalScene() :
+    layer(0),
+    clears(0)
+{
+}
+
+
+/*!
+ * Add text to the scene.  If a layer is set the text becomes its child, so
+ * the whole layer can be removed or moved as one item.
+ * \param text is the text to add
+ * \return the new text item
+ */
+QGraphicsTextItem* TwoDimensionalScene::addText(const QString & text)
+{
+    QGraphicsTextItem* item = myScene.addText(text);
+
+    if(layer)
+        item->setParentItem(layer);
+
+    return item;
+}
+
+
+/*!
+ * Add a path to the scene.  If a layer is set the path becomes its child, so
+ * the whole layer can be removed or moved as one item.  The path is included
+ * in the drawn bounds, so it should be a short path like a grid or axis, and
+ * the layer must not be transformed.
+ * \param path is the path to add
+ * \param pen is the pen used to stroke the path
+ * \return the new path item
+ */
+QGraphicsPathItem* TwoDimensionalScene::addPath(const QPainterPath & path, const QPen & pen)
+{
+    QGraphicsPathItem* item = myScene.addPath(path, pen);
+
+    if(layer)
+        item->setParentItem(layer);
+
+    // Half the pen sticks out past the path
+    double halfWidth = 0.5*pen.widthF();
+    includeBounds(path.controlPointRect().adjusted(-halfWidth, -halfWidth, halfWidth, halfWidth));
+
+    return item;
+}
+
 
-TwoDimensionalScene::TwoDimensionalScene()
+/*!
+ * Set the position of a text item, and include it in the drawn bounds.  The
+ * layer must not be transformed.
+ * \param item is the text item to position
+ * \param pos is the position of the item
+ */
+void TwoDimensionalScene::placeText(QGraphicsTextItem* item, QPointF pos)
 {
+    item->setPos(pos);
+    includeBounds(item->boundingRect().translated(pos));
 }
 
+
+/*!
+ * Draw one strip of a recorded scene.  This only reads the recording, so it
+ * can be run on a worker thread.
+ * \param recording is the data of the QPicture of the whole image
+ * \param width is the width of the image in pixels
+ * \param top is the first row of the image in the strip
+ * \param rows is the number of rows in the strip
+ * \return the image of the strip
+ */
+static QImage drawStrip(QByteArray recording, int width, int top, int rows)
+{
+    // Each strip replays its own copy, QPicture is not safe to share across threads
+    QPicture picture;
+    picture.setData(recording.constData(), (uint)recording.size());
+
+    QImage strip(width, rows, QImage::Format_RGB32);
+    strip.fill(Qt::white);
+
+    // The clip is in the coordinates of the whole image, so drawing that falls
+    //   outside of the strip is rejected before it is rasterized
+    QPainter painter(&strip);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.translate(0, -top);
+    painter.setClipRect(0, top, width, rows);
+    picture.play(&painter);
+    painter.end();
+
+    return strip;
+}
+
+
+/*!
+ * Export the scene to an uncompressed TIFF image, which can be far larger than
+ * would fit in memory at once.  The scene is recorded once into a QPicture,
+ * since the items can only be touched from this thread.  The recording is then
+ * replayed into horizontal strips on the global thread pool, and each strip is
+ * written to the file as soon as the strips above it are done.  Every strip
+ * replays the whole recording, clipped to the strip, so the CPU cost is the
+ * number of strips times the cost of walking every command of the scene; a
+ * taller stripRows means fewer replays.  At most one strip per thread, plus
+ * the one being written, is in memory at a time, each width*stripRows*4
+ * bytes.
+ * \param fileName is the name of the TIFF file to create
+ * \param width is the width of the image in pixels
+ * \param height is the height of the image in pixels
+ * \param stripRows is the number of rows drawn by each task
+ * \return true if the whole image was written
+ */
+bool TwoDimensionalScene::exportTiled(const QString & fileName, int width, int height, int stripRows)
+{
+    QRectF source = bounds;
+    if(source.isEmpty())
+        source = myScene.itemsBoundingRect();
+
+    if(source.isEmpty() || (width <= 0) || (height <= 0) || (stripRows <= 0))
+        return false;
+
+    TiffStripWriter writer;
+    if(!writer.open(fileName, width, height, stripRows))
+        return false;
+
+    // Record the whole scene at the size of the image
+    QPicture picture;
+    QPainter recorder(&picture);
+    myScene.render(&recorder, QRectF(0, 0, width, height), source);
+    recorder.end();
+
+    QByteArray recording(picture.data(), (int)picture.size());
+
+    int strips = writer.strips();
+    int inFlight = QThreadPool::globalInstance()->maxThreadCount() + 1;
+    if(inFlight < 2)
+        inFlight = 2;
+
+    std::vector< QFuture<QImage> > futures(strips);
+    int next = 0;
+    bool ok = true;
+
+    // Strips are written in order, only the next few are drawn ahead of the writer
+    for(int written = 0; written < strips; written++)
+    {
+        while(ok && (next < strips) && (next - written < inFlight))
+        {
+            int top = next*stripRows;
+            int rows = (height - top < stripRows) ? (height - top) : stripRows;
+            futures[next] = QtConcurrent::run(drawStrip, recording, width, top, rows);
+            next++;
+        }
+
+        if(written >= next)
+            break;
+
+        if(ok)
+            ok = writer.writeStrip(futures[written].result());
+        else
+            futures[written].waitForFinished();
+
+        // Let go of the strip
+        futures[written] = QFuture<QImage>();
+    }
+
+    return writer.close() && ok;
+
+}// TwoDimensionalScene::exportTiled
+
 /*!
  * Given a rect that bounds an item, return a location offset such that when
  * passed to QGraphicsScene->setPos() the location is with respect to the rect center
@@ -127,7 +296,7 @@ void TwoDimensionalScene::setupView(QGraphicsView* view)
     size = view->rect();
 
     // No items in the scene
-    myScene.clear();
+    clear();
 
     // Fix the size and location of the scene to match the view
     // myScene.setSceneRect(0, 0, size.width(), size.height());
@@ -182,7 +351,7 @@ void TwoDimensionalScene::drawGrid(double xOrg, double yOrg, double xScale, doub
     }// for all vertical grid lines
 
     // Grid lines are in grey
-    myScene.addPath(path, color);
+    addPath(path, color);
 
 }// TwoDimensionalScene::drawGrid
 
@@ -212,14 +381,14 @@ void TwoDimensionalScene::DrawHorizontalAxis(double xOrg, double yOrg, double dX
     // The label, centered above the axis
     pos.setX(xOrg + dXScale*(dXMax - dXMin)/2.0);
     pos.setY(yOrg);
-    QGraphicsTextItem* item = myScene.addText(label);
+    QGraphicsTextItem* item = addText(label);
     item->setDefaultTextColor(color);
 
     // Label is above or below the line according to if this is a high or low line
     if(high)
-        item->setPos(pos + rectOffsetForTopCenter(item->boundingRect()));
+        placeText(item, pos + rectOffsetForTopCenter(item->boundingRect()));
     else
-        item->setPos(pos + rectOffsetForBottomCenter(item->boundingRect()));
+        placeText(item, pos + rectOffsetForBottomCenter(item->boundingRect()));
 
     // X-axis start point
     pos.setX(xOrg);
@@ -241,7 +410,7 @@ void TwoDimensionalScene::DrawHorizontalAxis(double xOrg, double yOrg, double dX
         // Tick mark text
         pos.setX(X);
         pos.setY(yOrg);
-        item = myScene.addText(QString("%1").arg(dXMin + dTickSpace*i, 0, 'f', precision));
+        item = addText(QString("%1").arg(dXMin + dTickSpace*i, 0, 'f', precision));
         item->setDefaultTextColor(color);
 
         // tick mark
@@ -250,18 +419,18 @@ void TwoDimensionalScene::DrawHorizontalAxis(double xOrg, double yOrg, double dX
         // Label is above or below the line according to if this is a high or low line
         if(high)
         {
-            item->setPos(pos + rectOffsetForBottomCenter(item->boundingRect()));
+            placeText(item, pos + rectOffsetForBottomCenter(item->boundingRect()));
             path.lineTo(X,yOrg+tickLength);
         }
         else
         {
 
-            item->setPos(pos + rectOffsetForTopCenter(item->boundingRect()));
+            placeText(item, pos + rectOffsetForTopCenter(item->boundingRect()));
             path.lineTo(X,yOrg-tickLength);
         }
 
     }// for all the ticks to be drawn
-    myScene.addPath(path, QPen(color));
+    addPath(path, QPen(color));
 
 }// TwoDimensionalScene::DrawHorizontalAxis
 
@@ -329,7 +498,7 @@ void TwoDimensionalScene::DrawVerticalAxis(double xOrg, double yOrg, double dYSc
     for(i = 0; i < labels.size(); i++)
     {
         // The label
-        item = myScene.addText(labels[i]);
+        item = addText(labels[i]);
 
         // Set the text color which could be different for each sucessive label
         if(i < colors.size())
@@ -382,6 +551,10 @@ void TwoDimensionalScene::DrawVerticalAxis(double xOrg, double yOrg, double dYSc
 
     }// If more than one text item
 
+    // The labels are where they belong now
+    for(i = 0; i < itemList.size(); i++)
+        includeBounds(itemList[i]->boundingRect().translated(itemList[i]->pos()));
+
 
     // Compute the 'average' color
     QColor color;
@@ -426,24 +599,24 @@ void TwoDimensionalScene::DrawVerticalAxis(double xOrg, double yOrg, double dYSc
         // Tick mark text
         pos.setX(xOrg);
         pos.setY(Y);
-        item = myScene.addText(QString("%1").arg(dYMin + dTickSpace*i, 0, 'f', precision));
+        item = addText(QString("%1").arg(dYMin + dTickSpace*i, 0, 'f', precision));
         item->setDefaultTextColor(color);
 
         path.moveTo(xOrg,Y);
 
         if(left)
         {
-            item->setPos(pos + rectOffsetForRightCenter(item->boundingRect()));
+            placeText(item, pos + rectOffsetForRightCenter(item->boundingRect()));
             path.lineTo(xOrg + tickLength, Y);
         }
         else
         {
-            item->setPos(pos + rectOffsetForLeftCenter(item->boundingRect()));
+            placeText(item, pos + rectOffsetForLeftCenter(item->boundingRect()));
             path.lineTo(xOrg - tickLength, Y);
         }
 
     }// for all ticks to be drawn
-    myScene.addPath(path, QPen(color));
+    addPath(path, QPen(color));
 
 }// TwoDimensionalScene::DrawVerticalAxis
 
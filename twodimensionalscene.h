@@ -17,13 +17,34 @@ public:
     virtual void setupView(QGraphicsView* view);
 
     //! Clear the display
-    void clear(void) {myScene.clear();}
+    void clear(void) {myScene.clear(); layer = 0; bounds = QRectF(); clears++;}
 
     //! Set the size of the scene from the view rect.
     void setSize(QRect rect) {size = rect;}
 
+    //! Set the item that receives everything drawn, null to draw straight into the scene
+    void setLayer(QGraphicsItem* item) {layer = item;}
+
+    //! \return the region of the scene covered by everything drawn since the last clear
+    QRectF getDrawnBounds(void) const {return bounds;}
+
+    //! Export the scene to a TIFF image of any size, drawn in strips on multiple threads
+    bool exportTiled(const QString & fileName, int width, int height, int stripRows = 256);
+
 protected:
 
+    //! Add text to the scene, as a child of the layer if there is one
+    QGraphicsTextItem* addText(const QString & text);
+
+    //! Add a path to the scene, as a child of the layer if there is one
+    QGraphicsPathItem* addPath(const QPainterPath & path, const QPen & pen);
+
+    //! Position a text item and include it in the drawn bounds
+    void placeText(QGraphicsTextItem* item, QPointF pos);
+
+    //! Include a region of the scene in the drawn bounds
+    void includeBounds(const QRectF & rect) {bounds |= rect.normalized();}
+
     //! location is with respect to the rect center
     QPointF rectOffsetForCenter(const QRectF rect) const;
 
@@ -75,6 +96,9 @@ protected:
 protected:
     QGraphicsScene myScene;     //!< The scene we render into
     QRect size;                 //!< The size of the view/scene
+    QGraphicsItem* layer;       //!< Parent of everything drawn, null for none
+    QRectF bounds;              //!< Region covered by everything drawn, so the scene never has to be walked to find it
+    uint64_t clears;            //!< Number of times the scene was cleared, so items kept by a derived class can be known to be gone
 };
 
 #endif // TWODIMENSIONALSCENE_H
@@ -0,0 +1,103 @@
+#include "waterfallitem.h"
+
+/*!
+ * Size the image and discard all rows.  Every pixel starts at color 0.
+ * \param bins is the number of bins in each row, the width of the image
+ * \param rows is the number of rows kept, the height of the image
+ * \param colors is the color table of the image
+ */
+void waterfallRing::reset(int bins, int rows, const QVector<QRgb> & colors)
+{
+    head = filled = 0;
+
+    if((bins <= 0) || (rows <= 0))
+    {
+        image = QImage();
+        return;
+    }
+
+    image = QImage(bins, rows, QImage::Format_Indexed8);
+    image.setColorTable(colors);
+    image.fill(0);
+}
+
+
+/*!
+ * Advance the ring to the next row, which replaces the oldest row once the
+ * ring is full.
+ * \return the scan line of the new row, to be filled with color indices, or
+ *         null if the ring has no size
+ */
+uchar* waterfallRing::nextRow(void)
+{
+    if(image.isNull())
+        return 0;
+
+    // Rows go up the image, so newest to oldest runs down the image
+    if(head == 0)
+        head = image.height() - 1;
+    else
+        head--;
+
+    if(filled < image.height())
+        filled++;
+
+    return image.scanLine(head);
+}
+
+
+/*!
+ * Create the item that draws a ring.  The item does not own the ring, which
+ * must outlive it.
+ * \param rowRing is the ring of rows to draw
+ * \param parent is the parent item, which can be null
+ */
+WaterfallItem::WaterfallItem(const waterfallRing* rowRing, QGraphicsItem* parent) :
+    QGraphicsItem(parent),
+    ring(rowRing)
+{
+}
+
+
+/*!
+ * Set the region of the scene covered by all the rows of the ring.  The
+ * newest row is at the top, and each bin is one column.
+ * \param rect is the region of the scene
+ */
+void WaterfallItem::setArea(const QRectF & rect)
+{
+    prepareGeometryChange();
+    area = rect.normalized();
+}
+
+
+/*!
+ * Draw the rows that have been written, newest at the top.  The rows from the
+ * head to the bottom of the image are drawn first, then the rows from the top
+ * of the image, if the ring has wrapped.
+ */
+void WaterfallItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    if((ring->filled <= 0) || area.isEmpty())
+        return;
+
+    const QImage & image = ring->image;
+    double rowHeight = area.height()/image.height();
+
+    // Bins are blocks of color, not a picture to be smoothed
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+
+    int first = image.height() - ring->head;
+    if(first > ring->filled)
+        first = ring->filled;
+
+    painter->drawImage(QRectF(area.left(), area.top(), area.width(), first*rowHeight), image, QRectF(0, ring->head, image.width(), first));
+
+    int second = ring->filled - first;
+    if(second > 0)
+        painter->drawImage(QRectF(area.left(), area.top() + first*rowHeight, area.width(), second*rowHeight), image, QRectF(0, 0, image.width(), second));
+
+}// WaterfallItem::paint
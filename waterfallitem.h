@@ -0,0 +1,74 @@
+#ifndef WATERFALLITEM_H
+#define WATERFALLITEM_H
+
+#include <QGraphicsItem>
+#include <QImage>
+#include <QPainter>
+#include <QRectF>
+#include <QRgb>
+#include <QVector>
+
+/*!
+ * \brief The waterfallRing class keeps the most recent rows of a waterfall in
+ * one 8-bit indexed image, used as a ring.
+ *
+ * Each new row overwrites the oldest row of the image in place, through its
+ * scan line, so adding a row costs one pass over the row and nothing is ever
+ * copied or scrolled. Rows are written from the bottom of the image up, so the
+ * newest row first and the oldest row last is at most two runs of the image,
+ * in order from the top down.
+ */
+class waterfallRing
+{
+public:
+    waterfallRing() :
+        head(0), filled(0)
+    {
+    }
+
+    //! Size the image and discard all rows
+    void reset(int bins, int rows, const QVector<QRgb> & colors);
+
+    //! Advance to the next row, overwriting the oldest row if the ring is full
+    uchar* nextRow(void);
+
+    //! \return the number of bins in each row
+    int bins(void) const {return image.width();}
+
+    //! \return the number of rows the ring holds
+    int rows(void) const {return image.height();}
+
+    QImage image;   //!< One row per line, one bin per pixel, colored through the color table
+    int head;       //!< Line of the image with the newest row
+    int filled;     //!< Number of rows written, up to the height of the image
+};
+
+
+/*!
+ * \brief The WaterfallItem class draws a waterfallRing, newest row at the top.
+ *
+ * The ring is drawn in at most two pieces, using source rectangles of the
+ * image to put the newest row first. Scrolling the waterfall is only a change
+ * of the head of the ring, the image itself is never moved.
+ */
+class WaterfallItem : public QGraphicsItem
+{
+public:
+    //! Create the item that draws a ring
+    WaterfallItem(const waterfallRing* ring, QGraphicsItem* parent = 0);
+
+    //! Set the region of the scene covered by all the rows of the ring
+    void setArea(const QRectF & rect);
+
+    //! \return the region of the scene covered by all the rows of the ring
+    virtual QRectF boundingRect(void) const override {return area;}
+
+    //! Draw the rows that have been written
+    virtual void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = 0) override;
+
+protected:
+    const waterfallRing* ring;  //!< The rows to draw
+    QRectF area;                //!< Region of the scene covered by all the rows
+};
+
+#endif // WATERFALLITEM_H
@@ -0,0 +1,231 @@
+#include "waterfallplot.h"
+#include <QGraphicsTextItem>
+#include <algorithm>
+#include <math.h>
+
+WaterfallPlot::WaterfallPlot() :
+    TwoDimensionalPlot(),
+    xTicks(5),
+    yTicks(5),
+    xFirst(0.0),
+    xWidth(1.0),
+    bins(256),
+    rowPeriod(1.0),
+    rows(256),
+    low(0.0),
+    high(1.0),
+    axes(0),
+    item(0)
+{
+    ring.reset((int)bins, (int)rows, colors.colorTable());
+}
+
+
+/*!
+ * Setup the view to contain our scene.  This clears the scene, so the items
+ * are created again.  The rows are kept.
+ * \param view is the view that displays the waterfall
+ */
+void WaterfallPlot::setupView(QGraphicsView* view)
+{
+    TwoDimensionalPlot::setupView(view);
+    rebuild();
+}
+
+
+/*!
+ * Configure the waterfall.  This discards all rows.  The data of the plot data
+ * passed in is ignored, only the descriptions are used.
+ * \param plotTitle is the plot title
+ * \param xTickCount is the approximate number of desired tick marks in the x axis
+ * \param yTickCount is the approximate number of desired tick marks in the y axis
+ * \param xDescription describes the x axis, which is the bins
+ * \param firstBin is the x value of the center of the first bin
+ * \param binWidth is the width of each bin in x
+ * \param binCount is the number of bins in each row
+ * \param yDescription describes the y axis, which is the time before the newest row
+ * \param period is the time between rows
+ * \param rowCount is the number of rows kept
+ */
+void WaterfallPlot::setupWaterfall(const QString & plotTitle, uint32_t xTickCount, uint32_t yTickCount, const plotData & xDescription, double firstBin, double binWidth, size_t binCount, const plotData & yDescription, double period, size_t rowCount)
+{
+    title = plotTitle;
+    xTicks = xTickCount;
+    yTicks = yTickCount;
+
+    xAxis.title = xDescription.title;
+    xAxis.color = xDescription.color;
+    xAxis.scaler = xDescription.scaler;
+    xAxis.drawAxis = xDescription.drawAxis;
+    xAxis.labelsHigh = xDescription.labelsHigh;
+
+    yAxis.title = yDescription.title;
+    yAxis.color = yDescription.color;
+    yAxis.scaler = yDescription.scaler;
+    yAxis.drawAxis = yDescription.drawAxis;
+    yAxis.drawFirstLabel = yDescription.drawFirstLabel;
+    yAxis.labelsHigh = yDescription.labelsHigh;
+
+    xFirst = firstBin;
+    xWidth = (binWidth > 0.0) ? binWidth : 1.0;
+    bins = (binCount > 0) ? binCount : 1;
+    rowPeriod = (period > 0.0) ? period : 1.0;
+    rows = (rowCount > 0) ? rowCount : 1;
+
+    ring.reset((int)bins, (int)rows, colors.colorTable());
+
+    clear();
+    rebuild();
+
+}// WaterfallPlot::setupWaterfall
+
+
+/*!
+ * Set the values that map to the first and last colors of the color map.  This
+ * only applies to rows added from now on, rows already added keep their colors.
+ * \param lowValue maps to the first color, lower values are clamped to it
+ * \param highValue maps to the last color, higher values are clamped to it
+ */
+void WaterfallPlot::setLevels(double lowValue, double highValue)
+{
+    low = lowValue;
+    high = highValue;
+}
+
+
+/*!
+ * Set the colors of the waterfall.  The rows hold color indices, so this
+ * recolors every row by replacing the color table of the image, without
+ * touching the rows.
+ * \param map is the new color map
+ */
+void WaterfallPlot::setColorMap(const ColorMap & map)
+{
+    colors = map;
+    ring.image.setColorTable(colors.colorTable());
+
+    if(item)
+        item->update();
+}
+
+
+/*!
+ * Add a spectrum as the newest row, replacing the oldest row once the ring is
+ * full.  Each value is written straight into the scan line of the image as a
+ * color index, so the cost is O(bins).  Only the waterfall item is repainted.
+ * \param spectrum is the value of each bin
+ * \param count is the number of values, missing bins get the first color and
+ *        extra values are ignored
+ */
+void WaterfallPlot::appendRow(const double* spectrum, size_t count)
+{
+    uchar* line = ring.nextRow();
+    if(line == 0)
+        return;
+
+    double span = high - low;
+    double scale = (span != 0.0) ? 1.0/span : 0.0;
+
+    if(count > bins)
+        count = bins;
+
+    for(size_t i = 0; i < count; i++)
+        line[i] = (uchar)ColorMap::index((spectrum[i] - low)*scale);
+
+    for(size_t i = count; i < bins; i++)
+        line[i] = 0;
+
+    if(item)
+        item->update();
+
+}// WaterfallPlot::appendRow
+
+
+//! Create the items of the waterfall after the scene has been cleared
+void WaterfallPlot::rebuild(void)
+{
+    // The scene has been cleared, so these are gone
+    axes = 0;
+
+    item = new WaterfallItem(&ring);
+    item->setZValue(1.0);
+    myScene.addItem(item);
+
+    layoutAxes();
+}
+
+
+/*!
+ * Lay out the grid, axes, and title, and place the waterfall item on the grid.
+ * This only depends on the configuration, so it is not done as rows are added.
+ */
+void WaterfallPlot::layoutAxes(void)
+{
+    if(item == 0)
+        return;
+
+    QRectF region = size;
+
+    // Origin of the grid in pixels
+    double yOrg = region.bottom();
+    double xOrg = region.left();
+
+    // The bins are centered on their x values, so the edges are half a bin out
+    double left = (xFirst - 0.5*xWidth)*xAxis.scaler;
+    double right = (xFirst + (bins - 0.5)*xWidth)*xAxis.scaler;
+    if(right < left)
+        std::swap(left, right);
+
+    // The newest row is now, and older rows are in the past
+    double oldest = -(rows*rowPeriod)*fabs(yAxis.scaler);
+    double newest = 0.0;
+
+    double xMin, xMax, yMin, yMax;
+    uint32_t numXticks = xTicks;
+    int32_t xdigits = TwoDimensionalScene::tickMarks(left, right, &numXticks, &xMin, &xMax);
+
+    uint32_t numYticks = yTicks;
+    int32_t ydigits = TwoDimensionalScene::tickMarks(oldest, newest, &numYticks, &yMin, &yMax);
+
+    // Figure out graph scaling, remember top - bottom is a negative number
+    double xScale = region.width()/(xMax - xMin);
+    double yScale = region.height()/(yMin - yMax);
+
+    // Replace the old axes
+    delete axes;
+    bounds = QRectF();
+    axes = myScene.addRect(QRectF(), QPen(Qt::NoPen));
+    setLayer(axes);
+
+    drawGrid(xOrg, yOrg, xScale, xMin, xMax, numXticks*2, yScale, yMin, yMax, numYticks*2);
+
+    if(xAxis.drawAxis)
+        DrawHorizontalAxis(xOrg, yOrg, xScale, xMin, xMax, numXticks, xAxis.title, xdigits, xAxis.color, xAxis.labelsHigh);
+
+    if(yAxis.drawAxis)
+        DrawVerticalAxis(xOrg, yOrg, yScale, yMin, yMax, numYticks, yAxis.title, ydigits, yAxis.color, !yAxis.labelsHigh, yAxis.drawFirstLabel);
+
+    // Add the title to the plot
+    if(!title.isEmpty())
+    {
+        QPointF pos;
+        QGraphicsTextItem* text = addText(title);
+
+        // Title is centered at the top
+        pos.setY(region.top());
+        pos.setX((region.left()+region.right())*0.5);
+        pos += rectOffsetForTopCenter(text->boundingRect());
+        placeText(text, pos);
+    }
+
+    setLayer(0);
+
+    // The rows cover the bins across, and the ring down from now
+    QRectF area(QPointF(xOrg + (left - xMin)*xScale, yOrg + (newest - yMin)*yScale),
+                QPointF(xOrg + (right - xMin)*xScale, yOrg + (oldest - yMin)*yScale));
+    item->setArea(area);
+    includeBounds(area);
+
+    fitAllInView();
+
+}// WaterfallPlot::layoutAxes
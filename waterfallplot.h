@@ -0,0 +1,79 @@
+#ifndef WATERFALLPLOT_H
+#define WATERFALLPLOT_H
+
+#include "twodimensionalplot.h"
+#include "colormap.h"
+#include "waterfallitem.h"
+#include <QGraphicsRectItem>
+#include <stdint.h>
+
+/*!
+ * \brief The WaterfallPlot class is a TwoDimensionalPlot of a stream of
+ * spectra, such as vibration spectra, scrolling down as time goes on.
+ *
+ * Each spectrum is one row of colored bins, newest at the top. The rows are
+ * kept in a ring of an 8-bit indexed image, see waterfallRing, and each value
+ * is turned into a color index through a ColorMap as its row is written. A new
+ * row is O(bins) no matter how many rows are kept, and neither the image nor
+ * the axes are redrawn to scroll. The x axis is the bins, and the y axis is
+ * the time before the newest row. TwoDimensionalPlot is a protected base, so
+ * generatePlot() and clear() cannot delete the image or axes items out from
+ * under the waterfall.
+ */
+class WaterfallPlot : protected TwoDimensionalPlot
+{
+public:
+    WaterfallPlot();
+
+    //! Setup the view to contain our scene
+    virtual void setupView(QGraphicsView* view) override;
+
+    using TwoDimensionalScene::getDrawnBounds;
+    using TwoDimensionalScene::exportTiled;
+    using TwoDimensionalPlot::fitAllInView;
+
+    //! Configure the title, axes, bins, and rows, discarding all rows
+    void setupWaterfall(const QString & plotTitle, uint32_t xTickCount, uint32_t yTickCount, const plotData & xDescription, double firstBin, double binWidth, size_t binCount, const plotData & yDescription, double period, size_t rowCount);
+
+    //! Set the values that map to the first and last colors
+    void setLevels(double lowValue, double highValue);
+
+    //! Set the colors of the waterfall, which recolors every row
+    void setColorMap(const ColorMap & map);
+
+    //! Add a spectrum as the newest row
+    void appendRow(const double* spectrum, size_t count);
+
+    //! Add a spectrum as the newest row
+    void appendRow(const array & spectrum) {appendRow(spectrum.data(), spectrum.size());}
+
+    //! \return the number of bins in each row
+    size_t getBins(void) const {return bins;}
+
+    //! \return the number of rows kept
+    size_t getRows(void) const {return rows;}
+
+protected:
+    void rebuild(void);
+    void layoutAxes(void);
+
+protected:
+    QString title;                  //!< The plot title
+    uint32_t xTicks;                //!< Approximate number of x axis tick marks
+    uint32_t yTicks;                //!< Approximate number of y axis tick marks
+    plotData xAxis;                 //!< Title, color, and scaler of the x axis
+    plotData yAxis;                 //!< Title, color, and scaler of the y axis
+    double xFirst;                  //!< x value of the center of the first bin
+    double xWidth;                  //!< Width of each bin in x
+    size_t bins;                    //!< Number of bins in each row
+    double rowPeriod;               //!< Time between rows
+    size_t rows;                    //!< Number of rows kept
+    double low;                     //!< Value that maps to the first color
+    double high;                    //!< Value that maps to the last color
+    ColorMap colors;                //!< Colors of the values
+    waterfallRing ring;             //!< The most recent rows
+    QGraphicsRectItem* axes;        //!< Parent of the grid, axes, and title
+    WaterfallItem* item;            //!< Draws the ring
+};
+
+#endif // WATERFALLPLOT_H